@@ -0,0 +1,122 @@
+/****************************************************************************************************************************
+  ADC_Sampler.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Streaming ADC sampling at an exact rate, instead of analogRead() in ISR_Timer callbacks.
+   TCB2 starts each ADC0 conversion through the Event System, so the CPU never waits for a conversion.
+   The ADC result-ready ISR stores the samples of 2 channels, in round-robin sequence, into a double buffer,
+   and loop() averages each full block.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_ADCSampler.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_0     false
+#define USE_TIMER_1     false
+#define USE_TIMER_2     true
+#define USE_TIMER_3     false
+
+// 2 channels => 32 samples per block, 16 of each channel
+#define ADC_SAMPLER_BLOCK_SIZE      32
+#define ADC_SAMPLER_NUM_BLOCKS      2
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_ADCSampler.h"
+
+// A0 (PD3 => AIN3) and A1 (PD2 => AIN2) on Nano Every. Use ADC_MUXPOS_AIN0_gc and ADC_MUXPOS_AIN1_gc on UNO WiFi Rev2
+const uint8_t adcChannels[] = { ADC_MUXPOS_AIN3_gc, ADC_MUXPOS_AIN2_gc };
+
+#define NUM_ADC_CHANNELS          ( sizeof(adcChannels) / sizeof(adcChannels[0]) )
+
+// 1000Hz per channel
+#define SAMPLE_RATE_HZ            ( 1000 * NUM_ADC_CHANNELS )
+
+#define ADC_EVSYS_CHANNEL         2
+
+#define REPORT_INTERVAL_MS        1000
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting ADC_Sampler on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	ITimer2.init();
+
+	if (ADCSampler0.begin(ITimer2, ADC_EVSYS_CHANNEL, SAMPLE_RATE_HZ, adcChannels, NUM_ADC_CHANNELS))
+	{
+		Serial.print(F("Starting  ADCSampler0 OK, rate = "));
+		Serial.println(ADCSampler0.getTimerRate());
+	}
+	else
+		Serial.println(F("Can't set ADCSampler0. Select another rate or timer"));
+}
+
+void loop()
+{
+	static unsigned long lastReportTime = 0;
+	static uint32_t      sums[NUM_ADC_CHANNELS];
+	static uint16_t      counts = 0;
+
+	const uint16_t* block = ADCSampler0.getBlock();
+
+	if (block != NULL)
+	{
+		for (uint16_t i = 0; i < ADC_SAMPLER_BLOCK_SIZE; i++)
+			sums[i % NUM_ADC_CHANNELS] += block[i];
+
+		counts += ADC_SAMPLER_BLOCK_SIZE / NUM_ADC_CHANNELS;
+
+		ADCSampler0.releaseBlock();
+	}
+
+	if (millis() - lastReportTime >= REPORT_INTERVAL_MS)
+	{
+		lastReportTime = millis();
+
+		for (uint8_t channel = 0; channel < NUM_ADC_CHANNELS; channel++)
+		{
+			Serial.print(F("AIN"));
+			Serial.print(adcChannels[channel]);
+			Serial.print(F(" = "));
+			Serial.print( (counts == 0) ? 0 : sums[channel] / counts );
+			Serial.print(F(", "));
+
+			sums[channel] = 0;
+		}
+
+		counts = 0;
+
+		Serial.print(F("rate = "));
+		Serial.print(ADCSampler0.getSampleRate());
+		Serial.print(F(" Hz, overruns = "));
+		Serial.println(ADCSampler0.getOverruns());
+	}
+}
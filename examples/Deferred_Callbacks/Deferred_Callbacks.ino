@@ -0,0 +1,139 @@
+/****************************************************************************************************************************
+  Deferred_Callbacks.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* ISR_Timer run from the ISR of ITimer1, every 1ms, with its slow callbacks deferred to loop() through a
+   TimerEventQueue. The ISR only posts them, so that a 3ms "sensor processing" doesn't delay the 1ms ISR, nor the
+   LED timer still called from the ISR. Events are stamped by ITimeStamp2, and the worst delay from post to call,
+   the queue high-water mark and the dropped events are printed every second to size the queue.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1               true
+#define USE_TIMESTAMP_TIMER_2     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_TimeStamp.h"
+#include "megaAVR_TimerEventQueue.h"
+#include "megaAVR_ISR_Timer.h"
+
+#define TIMER1_INTERVAL_MS        1L
+
+#define LED_INTERVAL_MS           500L
+#define SENSOR_INTERVAL_MS        20L
+#define REPORT_INTERVAL_MS        1000L
+
+ISR_Timer ISR_timer;
+
+// Up to 7 events waiting for loop()
+TimerEventQueueT<8> deferred;
+
+volatile uint32_t sensorRuns  = 0;
+uint32_t          maxDelay    = 0;
+
+void TimerHandler1()
+{
+	ISR_timer.run();
+}
+
+// Quick : still called from ISR
+void toggleLED()
+{
+	digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+// Slow : deferred
+void processSensor()
+{
+	uint32_t delayTicks = deferred.getEventDelay();
+
+	if (delayTicks > maxDelay)
+		maxDelay = delayTicks;
+
+	delayMicroseconds(3000);
+
+	sensorRuns++;
+}
+
+// Slow : deferred
+void report()
+{
+	Serial.print(F("sensor runs = "));
+	Serial.print(sensorRuns);
+	Serial.print(F(", max delay us = "));
+	Serial.print(ITimeStamp2.ticksToUs(maxDelay));
+	Serial.print(F(", queue high-water = "));
+	Serial.print(deferred.getHighWaterMark());
+	Serial.print(F("/"));
+	Serial.print(deferred.getCapacity());
+	Serial.print(F(", dropped = "));
+	Serial.println(deferred.getDropped());
+
+	sensorRuns  = 0;
+	maxDelay    = 0;
+	deferred.resetStats();
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting Deferred_Callbacks on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	pinMode(LED_BUILTIN, OUTPUT);
+
+	ITimeStamp2.begin(TCB_CLKSEL_CLKDIV1_gc);
+	deferred.attachTimeStamp(ITimeStamp2);
+
+	ISR_timer.setEventQueue(&deferred);
+
+	ISR_timer.setInterval(LED_INTERVAL_MS, toggleLED);
+	ISR_timer.setDeferred(ISR_timer.setInterval(SENSOR_INTERVAL_MS, processSensor));
+	ISR_timer.setDeferred(ISR_timer.setInterval(REPORT_INTERVAL_MS, report));
+
+	ITimer1.init();
+
+	if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS, TimerHandler1))
+	{
+		Serial.print(F("Starting  ITimer1 OK, millis() = "));
+		Serial.println(millis());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+	// The deferred callbacks run here
+	deferred.dispatch();
+}
@@ -0,0 +1,80 @@
+/****************************************************************************************************************************
+  EVSYS_Event_Routing.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Periodic hardware action without any ISR.
+   The compare event of TCB1, at the end of each period, is routed through an EVSYS channel to the event output
+   EVOUTA (PA2, SDA on UNO WiFi Rev2 and Nano Every), which pulses once per period. Any other event user,
+   e.g. EVSYS.USERADC0 to start an ADC conversion, or EVSYS.USERTCB2 to clock another timer, can be connected
+   to the same channel. No callback is given, so TCB1 never interrupts the CPU.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_0     false
+#define USE_TIMER_1     true
+#define USE_TIMER_2     false
+#define USE_TIMER_3     false
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+
+#define TIMER1_INTERVAL_US        1000
+
+#define TIMER1_EVSYS_CHANNEL      1
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting EVSYS_Event_Routing on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	// EVOUTA is on PA2
+	pinMode(SDA, OUTPUT);
+
+	ITimer1.init();
+
+	// The EVSYS channel must be set before a period without callback
+	ITimer1.setEventOutput(TIMER1_EVSYS_CHANNEL);
+	TimerInterrupt_setEventUser(EVSYS.USEREVOUTA, TIMER1_EVSYS_CHANNEL);
+
+	if (ITimer1.setIntervalUs(TIMER1_INTERVAL_US, (timer_callback) NULL))
+	{
+		Serial.print(F("Starting  ITimer1 OK, EVSYS channel = "));
+		Serial.println(ITimer1.getEventOutput());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another interval or timer"));
+}
+
+void loop()
+{
+}
@@ -0,0 +1,107 @@
+/****************************************************************************************************************************
+  Hardware_PWM8.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Hardware 8-bit PWM on TCB1, as an alternative to FakeAnalogWrite.
+   The PWM is generated by the TCB in PWM8 mode, without any interrupt, so it uses no CPU time at any frequency.
+   The output is on the WO pin of TCB1 : PA3, or PF5 (D3 on UNO WiFi Rev2 and Nano Every) with PORTMUX.TCBROUTEA.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_0     false
+#define USE_TIMER_1     true
+#define USE_TIMER_2     false
+#define USE_TIMER_3     false
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+
+// PF5, D3 on UNO WiFi Rev2 and Nano Every
+#define PWM_PIN               3
+
+#define PWM_FREQUENCY_HZ      1000
+
+#define RAMP_STEP_MS          10
+
+void printPWM8Frequencies(const char* name, const uint8_t& clkSel)
+{
+	Serial.print(name);
+	Serial.print(F(" : "));
+	Serial.print(TimerInterrupt_PWM8MinFrequency(clkSel));
+	Serial.print(F(" - "));
+	Serial.print(TimerInterrupt_PWM8MaxFrequency(clkSel));
+	Serial.println(F(" Hz"));
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting Hardware_PWM8 on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	Serial.println(F("PWM8 frequencies reachable with each TCB clock"));
+	printPWM8Frequencies("CLK_PER   ", TCB_CLKSEL_CLKDIV1_gc);
+	printPWM8Frequencies("CLK_PER/2 ", TCB_CLKSEL_CLKDIV2_gc);
+	printPWM8Frequencies("CLK_TCA   ", TCB_CLKSEL_CLKTCA_gc);
+
+	// Route TCB1 WO to PF5
+	PORTMUX.TCBROUTEA |= PORTMUX_TCB1_bm;
+	pinMode(PWM_PIN, OUTPUT);
+
+	ITimer1.init();
+
+	if (ITimer1.setPWM8Frequency(PWM_FREQUENCY_HZ, 0))
+	{
+		Serial.print(F("Starting  ITimer1 PWM8 OK, frequency = "));
+		Serial.print(ITimer1.getPWM8Frequency());
+		Serial.print(F(" Hz, duty steps = "));
+		Serial.println(ITimer1.getPWM8Top() + 1);
+	}
+	else
+		Serial.println(F("Can't set ITimer1 PWM8. Select another freq. or timer"));
+}
+
+void loop()
+{
+	static int16_t  duty  = 0;
+	static int8_t   step  = 1;
+
+	// Ramp duty up and down, one tick at a time, from always low to always high
+	ITimer1.setPWM8DutyTicks(duty);
+
+	if ( (duty + step < 0) || (duty + step > ITimer1.getPWM8Top() + 1) )
+		step = -step;
+
+	duty += step;
+
+	delay(RAMP_STEP_MS);
+}
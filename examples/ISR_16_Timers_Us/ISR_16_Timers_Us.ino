@@ -0,0 +1,114 @@
+/****************************************************************************************************************************
+  ISR_16_Timers_Us.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* 15 sub-ms periodic ISR_Timer timers, from 200us to 900us, plus a 1s one for the report, sharing ITimer1 in tickless mode. Time is counted in
+   ticks of the TCB clock, 62.5ns with TCB_CLKSEL_CLKDIV1_gc, instead of millis(), so that the intervals aren't
+   rounded to ms. Each second, the number of calls of each timer is printed, with the expected one.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// Tickless mode needs the default TIMER_ISR_POLICY_FULL for this timer
+#define USE_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_ISR_Timer.h"
+
+ISR_Timer ISR_timer;
+
+#define NUMBER_ISR_TIMERS         16
+
+#define FIRST_INTERVAL_US         200L
+#define INTERVAL_STEP_US          50L
+
+#define REPORT_INTERVAL_MS        1000L
+
+volatile uint32_t callCount[NUMBER_ISR_TIMERS];
+
+volatile bool report = false;
+
+void countCall(void* timerNo)
+{
+	callCount[(uintptr_t) timerNo]++;
+}
+
+void requestReport()
+{
+	report = true;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting ISR_16_Timers_Us on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	// Before setting any timer
+	if (ISR_timer.attachTickless(ITimer1, TCB_CLKSEL_CLKDIV1_gc))
+	{
+		Serial.print(F("Tickless ISR_Timer on ITimer1, ticks/s = "));
+		Serial.println(ISR_timer.getUnitsPerSecond());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another Timer, freq. or timer"));
+
+	for (uint16_t i = 0; i < NUMBER_ISR_TIMERS - 1; i++)
+		ISR_timer.setIntervalUs(FIRST_INTERVAL_US + (i * INTERVAL_STEP_US), countCall, (void *) (uintptr_t) i);
+
+	// Last timer for the report
+	ISR_timer.setInterval(REPORT_INTERVAL_MS, requestReport);
+}
+
+void loop()
+{
+	if (report)
+	{
+		report = false;
+
+		for (uint16_t i = 0; i < NUMBER_ISR_TIMERS - 1; i++)
+		{
+			noInterrupts();
+
+			uint32_t count = callCount[i];
+			callCount[i] = 0;
+
+			interrupts();
+
+			Serial.print(FIRST_INTERVAL_US + (i * INTERVAL_STEP_US));
+			Serial.print(F("us : "));
+			Serial.print(count);
+			Serial.print(F(" calls/s, expected "));
+			Serial.println(1000000L / (FIRST_INTERVAL_US + (i * INTERVAL_STEP_US)));
+		}
+	}
+}
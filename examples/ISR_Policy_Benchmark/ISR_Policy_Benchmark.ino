@@ -0,0 +1,144 @@
+/****************************************************************************************************************************
+  ISR_Policy_Benchmark.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+
+/*
+   Notes:
+   Measures the CPU cycles spent per ISR(TCB1_INT_vect), including the empty callback, by comparing the work
+   done by loop() in a fixed window with and without ITimer1 running at TIMER1_FREQUENCY.
+   Build once with each TIMER1_ISR_POLICY to compare. Without TIMER1_ISR_POLICY support (library before v1.8.0),
+   the sketch measures the old ISR body.
+   Cycles per ISR, from an instruction-level simulation of the ISR of this sketch built with clang 14 (AVR backend,
+   -Os, avrxmega3), as no avr-gcc was at hand. avr-gcc builds, as by the IDE, may differ. "Periodic" is the ISR
+   at TIMER1_FREQUENCY with this callback, interrupt response and vector jump included. "Worst path" is from
+   extras/ISR_WCET, without the callback, and without micros() of the event queue in the deferred policies :
+
+     TIMER1_ISR_POLICY               periodic    worst path
+     v1.7.0 ISR body                    206          350
+     TIMER_ISR_POLICY_FULL              213          422
+     TIMER_ISR_NO_DURATION              156          350
+     TIMER_ISR_NO_LONG_PERIOD           180          378
+     TIMER_ISR_NO_PARAMS                203          422
+     TIMER_ISR_NO_DEFER                 203          198
+     TIMER_ISR_POLICY_MINIMAL           102           74
+
+   The sketch builds with extras/HostSim, but the host doesn't time AVR instructions (an ISR takes the cycles given
+   to HostSim_setISRCycles()), so the "Cycles per ISR" printed there means nothing.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USING_16MHZ     true
+#define USING_8MHZ      false
+#define USING_250KHZ    false
+
+#define USE_TIMER_0     false
+#define USE_TIMER_1     true
+#define USE_TIMER_2     false
+#define USE_TIMER_3     false
+
+// Select one, TIMER_ISR_POLICY_FULL is the default
+//#define TIMER1_ISR_POLICY     TIMER_ISR_POLICY_FULL
+#define TIMER1_ISR_POLICY     TIMER_ISR_POLICY_MINIMAL
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+
+#define TIMER1_FREQUENCY      20000UL
+#define WINDOW_MS             2000UL
+
+volatile uint32_t Timer1Count = 0;
+
+void TimerHandler1()
+{
+	Timer1Count++;
+}
+
+// Busy work done in WINDOW_MS
+uint32_t measureWork()
+{
+	volatile uint32_t work = 0;
+	uint32_t startTime = millis();
+
+	while (millis() - startTime < WINDOW_MS)
+	{
+		work++;
+	}
+
+	return work;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting ISR_Policy_Benchmark on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+#if defined(TIMER_ISR_POLICY_FULL)
+	Serial.print(F("TIMER1_ISR_POLICY = "));
+	Serial.println(TIMER1_ISR_POLICY);
+#endif
+
+	ITimer1.init();
+
+	uint32_t baseline = measureWork();
+
+	if (!ITimer1.attachInterrupt(TIMER1_FREQUENCY, TimerHandler1))
+	{
+		Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+		return;
+	}
+
+	Timer1Count = 0;
+	uint32_t loaded = measureWork();
+	uint32_t isrCount = Timer1Count;
+
+	ITimer1.detachInterrupt();
+
+	// Cycles in window not left to loop(), shared by the interrupts
+	float cyclesPerISR = ( (float) (baseline - loaded) / baseline ) * ( (float) F_CPU * WINDOW_MS / 1000 ) / isrCount;
+
+	Serial.print(F("Baseline work = "));
+	Serial.print(baseline);
+	Serial.print(F(", with ITimer1 = "));
+	Serial.print(loaded);
+	Serial.print(F(", interrupts = "));
+	Serial.println(isrCount);
+
+	Serial.print(F("Cycles per ISR, including callback = "));
+	Serial.println(cyclesPerISR);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,132 @@
+/****************************************************************************************************************************
+  ISR_Timer_Benchmark.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* CPU cycles spent in ISR_Timer::run(), called from the hardware timer ISR on each tick, with 1, 8 and 16 timers.
+   run() is called here directly from loop(), with interrupts disabled, and timed by TCB2 counting CLK_PER.
+   "Full scan" is a tick after timers were added, or when one is due. "Idle" is any other tick, returning after
+   the next-deadline check. Run the same sketch with an older library version to compare.
+   Cycles of run() (full scan / idle), from an instruction-level simulation of this sketch built with clang 14
+   (AVR backend, -Os, avrxmega3), as no avr-gcc was at hand. avr-gcc builds, as by the IDE, may differ :
+
+                                       1 timer       8 timers       16 timers
+     v1.7.0, scan of all slots        1200 / 1199    1536 / 1535    1920 / 1919
+     next deadline cached             1315 / 171     2141 / 171     3085 / 171
+     idle check inlined in run()       407 / 132     1681 / 132     3497 / 132
+
+   The full scan, which also finds the next deadline, runs only when a timer is due or was changed.
+   The sketch builds with extras/HostSim, but the host doesn't time AVR instructions, and prints the same
+   meaningless count (20 cycles) for every case there.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_ISR_Timer.h"
+
+ISR_Timer ISR_timer;
+
+#define NUM_IDLE_RUNS         100
+
+// Long enough for no timer to be due while measuring
+#define TIMER_INTERVAL_MS     60000L
+
+void doingNothing()
+{
+}
+
+// Cycles of one ISR_timer.run(), measured by TCB2 running at CLK_PER
+uint16_t cyclesOfRun()
+{
+	noInterrupts();
+
+	uint16_t start = TCB2.CNT;
+	ISR_timer.run();
+	uint16_t end   = TCB2.CNT;
+
+	interrupts();
+
+	return end - start;
+}
+
+void benchmark(const uint8_t& numTimers)
+{
+	ISR_timer.init();
+
+	for (uint8_t i = 0; i < numTimers; i++)
+		ISR_timer.setInterval(TIMER_INTERVAL_MS + i, doingNothing);
+
+	uint16_t fullScan = cyclesOfRun();
+
+	uint32_t idle = 0;
+
+	for (uint16_t i = 0; i < NUM_IDLE_RUNS; i++)
+		idle += cyclesOfRun();
+
+	Serial.print(numTimers);
+	Serial.print(F(" timers : full scan = "));
+	Serial.print(fullScan);
+	Serial.print(F(" cycles, idle = "));
+	Serial.print(idle / NUM_IDLE_RUNS);
+	Serial.println(F(" cycles"));
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting ISR_Timer_Benchmark on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	// TCB2 free running at CLK_PER, no interrupt
+	TCB2.CTRLA  = 0;
+	TCB2.CTRLB  = TCB_CNTMODE_INT_gc;
+	TCB2.CCMP   = 0xFFFF;
+	TCB2.CNT    = 0;
+	TCB2.CTRLA  = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+
+	// Overhead of the measurement itself
+	noInterrupts();
+	uint16_t start = TCB2.CNT;
+	uint16_t end   = TCB2.CNT;
+	interrupts();
+
+	Serial.print(F("Measurement overhead = "));
+	Serial.print((uint16_t) (end - start));
+	Serial.println(F(" cycles"));
+
+	benchmark(1);
+	benchmark(8);
+	benchmark(16);
+}
+
+void loop()
+{
+}
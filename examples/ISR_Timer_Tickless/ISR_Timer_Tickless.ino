@@ -0,0 +1,140 @@
+/****************************************************************************************************************************
+  ISR_Timer_Tickless.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Tickless ISR_Timer : instead of a hardware timer interrupt every ms calling ISR_Timer.run(), ITimer1 is
+   reprogrammed to interrupt only at the next deadline. The interrupt rate is then the real event rate, and
+   timers can be set in 4us ticks with setIntervalTicks(). Here, 2 + 769 + 1 events/s instead of 1000 ticks/s.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// Tickless mode needs the default TIMER_ISR_POLICY_FULL for this timer
+#define USE_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_ISR_Timer.h"
+
+#if !defined(LED_BUILTIN)
+	#define LED_BUILTIN     13
+#endif
+
+ISR_Timer ISR_timer;
+
+#define LED_INTERVAL_MS           500L
+
+// 1.3ms, in 4us ticks of TCB_CLKSEL_CLKTCA_gc
+#define SAMPLE_INTERVAL_TICKS     325L
+
+#define REPORT_INTERVAL_MS        1000L
+
+volatile uint32_t sampleCount = 0;
+
+// Deviation (in us) of the sample interval from 1300us
+volatile uint32_t sampleLastUs    = 0;
+volatile uint16_t sampleMaxJitter = 0;
+
+volatile bool report = false;
+
+void toggleLED()
+{
+	digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void sample()
+{
+	uint32_t nowUs = micros();
+
+	if (sampleCount > 0)
+	{
+		uint32_t interval = nowUs - sampleLastUs;
+		uint16_t jitter   = (interval > 1300) ? (interval - 1300) : (1300 - interval);
+
+		if (jitter > sampleMaxJitter)
+			sampleMaxJitter = jitter;
+	}
+
+	sampleLastUs = nowUs;
+	sampleCount++;
+}
+
+void requestReport()
+{
+	report = true;
+}
+
+void setup()
+{
+	pinMode(LED_BUILTIN, OUTPUT);
+
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting ISR_Timer_Tickless on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	// Before setting any timer
+	if (ISR_timer.attachTickless(ITimer1))
+	{
+		Serial.print(F("Tickless ISR_Timer on ITimer1, ticks/s = "));
+		Serial.println(ISR_timer.getUnitsPerSecond());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another Timer, freq. or timer"));
+
+	ISR_timer.setInterval(LED_INTERVAL_MS, toggleLED);
+	ISR_timer.setIntervalTicks(SAMPLE_INTERVAL_TICKS, sample);
+	ISR_timer.setInterval(REPORT_INTERVAL_MS, requestReport);
+}
+
+void loop()
+{
+	if (report)
+	{
+		report = false;
+
+		noInterrupts();
+
+		uint32_t count  = sampleCount;
+		uint16_t jitter = sampleMaxJitter;
+
+		sampleMaxJitter = 0;
+
+		interrupts();
+
+		Serial.print(F("t = "));
+		Serial.print(ISR_timer.unitsToMs(ISR_timer.now()));
+		Serial.print(F("ms, samples = "));
+		Serial.print(count);
+		Serial.print(F(", max jitter = "));
+		Serial.print(jitter);
+		Serial.println(F("us"));
+	}
+}
@@ -0,0 +1,99 @@
+/****************************************************************************************************************************
+  OneShot_Pulse.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Hardware single-shot pulse on TCB1, in TCB Single Shot mode.
+   Each event on the EVSYS channel starts one pulse of exact length on the WO pin of TCB1
+   (PF5, D3 on UNO WiFi Rev2 and Nano Every with PORTMUX.TCBROUTEA), with no interrupt until the end of the pulse.
+   Here the event is fired by software every second. Routing a pin, e.g. EVSYS_GENERATOR_PORT0_PIN0_gc (D2),
+   to the same channel would start the pulse on each edge of that pin instead, without any CPU latency.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_0     false
+#define USE_TIMER_1     true
+#define USE_TIMER_2     false
+#define USE_TIMER_3     false
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+
+// PF5, D3 on UNO WiFi Rev2 and Nano Every
+#define PULSE_PIN             3
+
+#define PULSE_US              500
+#define ONESHOT_EVSYS_CHANNEL 0
+
+#define FIRE_INTERVAL_MS      1000
+
+volatile uint32_t pulsesDone = 0;
+
+void PulseDoneHandler()
+{
+	pulsesDone++;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting OneShot_Pulse on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	// Route TCB1 WO to PF5
+	PORTMUX.TCBROUTEA |= PORTMUX_TCB1_bm;
+	pinMode(PULSE_PIN, OUTPUT);
+
+	ITimer1.init();
+
+	if (ITimer1.setOneShotUs(PULSE_US, ONESHOT_EVSYS_CHANNEL, PulseDoneHandler))
+	{
+		Serial.print(F("Starting  ITimer1 OneShot OK, TCB Clock Frequency = "));
+		Serial.println(ITimer1.getClockFrequency());
+	}
+	else
+		Serial.println(F("Can't set ITimer1 OneShot. Select another pulse length or timer"));
+}
+
+void loop()
+{
+	static unsigned long lastFireTime = 0;
+
+	if (millis() - lastFireTime >= FIRE_INTERVAL_MS)
+	{
+		lastFireTime = millis();
+
+		ITimer1.fireOneShot();
+
+		Serial.print(F("Pulse fired, pulses done = "));
+		Serial.println(pulsesDone);
+	}
+}
@@ -0,0 +1,117 @@
+/****************************************************************************************************************************
+  RPM_Measure_Capture.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* RPM Measuring uses hardware input capture of TCB1 to measure the time of one rotation, in ticks of the TCB clock,
+   then convert to RPM. One rotation is detected by a magnetic REED SW or IR LED Sensor on interruptPin, assuming LOW is active.
+
+   The pin is routed through the Event System to TCB1, running in Frequency and Pulse-Width Measurement mode.
+   The hardware captures the rotation time and the active time at 4us resolution (250KHz TCB clock),
+   without any pin-change interrupt or timer polling. The noise filter ignores pulses shorter than 4 CLK_PER cycles.
+   For example: 250KHz clock => up to 262ms a rotation => minimum 229RPM.
+   RPM = 60 * 250000 / (rotation time in ticks)
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerCapture.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// TCB1 is used by ICapture1, and can't be used by ITimer1 at the same time
+#define USE_CAPTURE_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerCapture.h"
+
+// D2 is PA0 on UNO WiFi Rev2 and Nano Every. EVSYS channels 0 and 1 can select PORTA pins
+unsigned int interruptPin = 2;
+
+#define CAPTURE_EVSYS_CHANNEL     0
+#define CAPTURE_GENERATOR         EVSYS_GENERATOR_PORT0_PIN0_gc
+
+// No rotation captured for this time => RPM = 0
+#define IDLE_TIMEOUT_MS           1000
+
+float RPM       = 0.00;
+float avgRPM    = 0.00;
+
+uint8_t       lastSequence  = 0;
+unsigned long lastCaptureMs = 0;
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting RPM_Measure_Capture on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	pinMode(interruptPin, INPUT_PULLUP);
+
+	// LOW is active => start measuring on the falling edge
+	if (ICapture1.begin(TCB_CNTMODE_FRQPW_gc, CAPTURE_EVSYS_CHANNEL, CAPTURE_GENERATOR, TCB_CLKSEL_CLKTCA_gc, true, true))
+	{
+		Serial.print(F("Starting  ICapture1 OK, TCB Clock Frequency = "));
+		Serial.println(ICapture1.getClockFrequency());
+	}
+	else
+		Serial.println(F("Can't set ICapture1. Select another channel or timer"));
+}
+
+void loop()
+{
+	capture_t capture;
+
+	uint8_t sequence = ICapture1.getLatest(capture);
+
+	if ( (sequence != 0) && (sequence != lastSequence) && (capture.period != 0) )
+	{
+		lastSequence  = sequence;
+		lastCaptureMs = millis();
+
+		RPM = 60.0f * ICapture1.getClockFrequency() / capture.period;
+
+		avgRPM = ( 2 * avgRPM + RPM) / 3;
+
+		Serial.print(F("RPM = "));
+		Serial.print(avgRPM);
+		Serial.print(F(", rotationTime us = "));
+		Serial.print(1000000.0f * capture.period / ICapture1.getClockFrequency());
+		Serial.print(F(", active us = "));
+		Serial.println(1000000.0f * capture.pulseWidth / ICapture1.getClockFrequency());
+	}
+	else if ( (RPM != 0) && (millis() - lastCaptureMs > IDLE_TIMEOUT_MS) )
+	{
+		// If idle, set RPM to 0
+		RPM     = 0;
+		avgRPM  = 0;
+
+		Serial.println(F("RPM = 0"));
+	}
+
+	// Captures queued by the ISR are not used here. Drain the ring to keep only the latest value
+	while (ICapture1.read(capture));
+}
@@ -0,0 +1,128 @@
+/****************************************************************************************************************************
+  RPM_Measure_TimeStamp.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* RPM Measuring with a TimeStamp, TCB2 running free at 16MHz. The pin interrupt of each rotation reads ITimeStamp2.now(),
+   with 62.5ns resolution, instead of a 1ms timer counting the rotation time. There's then no periodic interrupt, and
+   no 1ms rounding : RPM = 60 * (ticks per second) / (rotation time in ticks).
+   For example: Max speed is 600RPM => 10 RPS => minimum 100ms a rotation. We'll use 80ms for debouncing.
+   The same TimeStamp is the time base of an ISR_Timer, run() from loop(), printing the RPM every second.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// TCB2 as TimeStamp, so not as TimerInterrupt
+#define USE_TIMESTAMP_TIMER_2     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_TimeStamp.h"
+#include "megaAVR_ISR_Timer.h"
+
+unsigned int interruptPin = 2;
+
+#define DEBOUNCING_INTERVAL_MS    80
+#define IDLE_INTERVAL_MS          5000
+#define REPORT_INTERVAL_MS        1000
+
+ISR_Timer ISR_timer;
+
+uint32_t debouncingTicks;
+uint32_t idleTicks;
+
+volatile uint32_t lastRotation  = 0;
+volatile uint32_t rotationTicks = 0;
+
+void detectRotation()
+{
+	// Cheap enough for an ISR, called with interrupts disabled
+	uint32_t now = ITimeStamp2.now();
+
+	if (now - lastRotation >= debouncingTicks)
+	{
+		rotationTicks = now - lastRotation;
+		lastRotation  = now;
+	}
+}
+
+void printRPM()
+{
+	noInterrupts();
+
+	// If idle, set RPM to 0, before now() wraps around lastRotation
+	if (ITimeStamp2.now() - lastRotation >= idleTicks)
+		rotationTicks = 0;
+
+	uint32_t ticks = rotationTicks;
+
+	interrupts();
+
+	float RPM = 0;
+
+	if (ticks != 0)
+		RPM = 60.0f * ITimeStamp2.getClockFrequency() / ticks;
+
+	Serial.print(F("RPM = "));
+	Serial.print(RPM);
+	Serial.print(F(", rotation time us = "));
+	Serial.println(ITimeStamp2.ticksToUs(ticks));
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting RPM_Measure_TimeStamp on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	if (ITimeStamp2.begin(TCB_CLKSEL_CLKDIV1_gc))
+	{
+		Serial.print(F("Starting  ITimeStamp2 OK, ticks/s = "));
+		Serial.println(ITimeStamp2.getClockFrequency());
+	}
+	else
+		Serial.println(F("Can't start ITimeStamp2. Select another timer"));
+
+	debouncingTicks = ITimeStamp2.usToTicks(DEBOUNCING_INTERVAL_MS * 1000UL);
+	idleTicks       = ITimeStamp2.usToTicks(IDLE_INTERVAL_MS * 1000UL);
+
+	ISR_timer.attachTimeStamp(ITimeStamp2);
+	ISR_timer.setInterval(REPORT_INTERVAL_MS, printRPM);
+
+	pinMode(interruptPin, INPUT_PULLUP);
+
+	// Assumming the interruptPin will go LOW
+	attachInterrupt(digitalPinToInterrupt(interruptPin), detectRotation, FALLING);
+}
+
+void loop()
+{
+	ISR_timer.run();
+}
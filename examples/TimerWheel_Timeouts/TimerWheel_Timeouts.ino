@@ -0,0 +1,134 @@
+/****************************************************************************************************************************
+  TimerWheel_Timeouts.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* TimerWheel : one timeout per connection, for NUM_CONNECTIONS connections, more than the 16 timers of ISR_Timer.
+   ITimer1 calls TimerWheel.run() every ms, whose cost doesn't depend on the number of timers. Activity on a
+   connection, simulated in loop(), deletes and sets its timeout again. Connections without activity time out.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_TimerWheel.h"
+
+#define NUM_CONNECTIONS           100
+
+// Timeouts, plus one timer for the report : 20 bytes each in SRAM, plus 256 bytes for the wheel
+TimerWheelT<NUM_CONNECTIONS + 1> timerWheel;
+
+// Tick of the wheel, so timeouts in ms
+#define TIMER_WHEEL_TICK_MS       1L
+
+#define CONNECTION_TIMEOUT_MS     2000L
+
+#define REPORT_INTERVAL_MS        5000L
+
+int timeoutIds[NUM_CONNECTIONS];
+
+volatile uint32_t activityCount = 0;
+volatile uint32_t timeoutCount  = 0;
+
+volatile bool report = false;
+
+void TimerHandler()
+{
+	timerWheel.run();
+}
+
+void onTimeout(void* connection)
+{
+	(void) connection;
+
+	timeoutCount++;
+}
+
+void requestReport()
+{
+	report = true;
+}
+
+// Activity on connection : its timeout starts again
+void activity(const uint16_t& connection)
+{
+	timerWheel.deleteTimer(timeoutIds[connection]);
+	timeoutIds[connection] = timerWheel.setTimeout(CONNECTION_TIMEOUT_MS / TIMER_WHEEL_TICK_MS, onTimeout,
+	                                               (void *) (uintptr_t) connection);
+
+	activityCount++;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting TimerWheel_Timeouts on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	for (uint16_t i = 0; i < NUM_CONNECTIONS; i++)
+		activity(i);
+
+	timerWheel.setInterval(REPORT_INTERVAL_MS / TIMER_WHEEL_TICK_MS, requestReport);
+
+	ITimer1.init();
+
+	if (ITimer1.attachInterruptInterval(TIMER_WHEEL_TICK_MS, TimerHandler))
+	{
+		Serial.print(F("Starting  ITimer1 OK, millis() = "));
+		Serial.println(millis());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+	// Random activity, leaving some connections idle long enough to time out
+	activity(random(NUM_CONNECTIONS));
+
+	delay(random(50));
+
+	if (report)
+	{
+		report = false;
+
+		Serial.print(F("t = "));
+		Serial.print(timerWheel.now());
+		Serial.print(F("ms, timers = "));
+		Serial.print(timerWheel.getNumTimers());
+		Serial.print(F(", activities = "));
+		Serial.print(activityCount);
+		Serial.print(F(", timeouts = "));
+		Serial.println(timeoutCount);
+	}
+}
@@ -0,0 +1,173 @@
+/****************************************************************************************************************************
+  Timer_Stats.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Latency and duration statistics of a TimerInterrupt callback, ITimer1 every 1ms with TCB clock at 16MHz, and of
+   ISR_Timer timers, run from that callback and timed by ITimeStamp2, also at 16MHz. A slow timer, and millis()
+   running in the TCA interrupt, delay the others. Printed every 2s, in us or ns, then reset.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USING_16MHZ     true
+#define USING_8MHZ      false
+#define USING_250KHZ    false
+
+#define USE_TIMER_1               true
+#define USE_TIMESTAMP_TIMER_2     true
+
+// Statistics of TimerInterrupt and ISR_Timer
+#define TIMER_INTERRUPT_USE_STATS     true
+#define ISR_TIMER_USE_STATS           true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_TimeStamp.h"
+#include "megaAVR_ISR_Timer.h"
+
+#define TIMER1_INTERVAL_MS        1L
+
+#define FAST_INTERVAL_MS          2L
+#define SLOW_INTERVAL_MS          10L
+
+#define REPORT_INTERVAL_MS        2000L
+
+ISR_Timer ISR_timer;
+
+int fastTimer;
+int slowTimer;
+
+void TimerHandler1()
+{
+	ISR_timer.run();
+}
+
+void fastWork()
+{
+	delayMicroseconds(20);
+}
+
+// Delays fastWork() when both are due
+void slowWork()
+{
+	delayMicroseconds(500);
+}
+
+// Ticks of a clock of ticksPerSecond to ns, exact for any TCB clock (250KHz, 312.5KHz, ...)
+uint32_t ticksToNs(const uint32_t& ticks, const uint32_t& ticksPerSecond)
+{
+	return (uint64_t) ticks * 1000000000UL / ticksPerSecond;
+}
+
+void printStats(const __FlashStringHelper* name, const timer_stats_t& stats, const uint32_t& ticksPerSecond)
+{
+	Serial.print(name);
+	Serial.print(F(": calls = "));
+	Serial.print(stats.calls);
+	Serial.print(F(", missed = "));
+	Serial.println(stats.missed);
+
+	if (stats.calls == 0)
+		return;
+
+	Serial.print(F("  latency ns min/mean/max = "));
+	Serial.print(ticksToNs(stats.latencyMin, ticksPerSecond));
+	Serial.print(F("/"));
+	Serial.print(ticksToNs(TimerInterrupt_meanLatencyOf(stats), ticksPerSecond));
+	Serial.print(F("/"));
+	Serial.println(ticksToNs(stats.latencyMax, ticksPerSecond));
+
+	Serial.print(F("  duration us min/mean/max = "));
+	Serial.print(ticksToNs(stats.durationMin, ticksPerSecond) / 1000);
+	Serial.print(F("/"));
+	Serial.print(ticksToNs(TimerInterrupt_meanDurationOf(stats), ticksPerSecond) / 1000);
+	Serial.print(F("/"));
+	Serial.println(ticksToNs(stats.durationMax, ticksPerSecond) / 1000);
+
+	// Latencies of 0, 1, 2-3, 4-7, ... ticks
+	Serial.print(F("  latency histogram ="));
+
+	for (uint8_t bin = 0; bin < TIMER_STATS_HISTOGRAM_BINS; bin++)
+	{
+		Serial.print(F(" "));
+		Serial.print(stats.histogram[bin]);
+	}
+
+	Serial.println();
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting Timer_Stats on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	ITimeStamp2.begin(TCB_CLKSEL_CLKDIV1_gc);
+
+	ISR_timer.attachTimeStamp(ITimeStamp2);
+
+	fastTimer = ISR_timer.setInterval(FAST_INTERVAL_MS, fastWork);
+	slowTimer = ISR_timer.setInterval(SLOW_INTERVAL_MS, slowWork);
+
+	ITimer1.init();
+
+	if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS, TimerHandler1))
+	{
+		Serial.print(F("Starting  ITimer1 OK, millis() = "));
+		Serial.println(millis());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+}
+
+void loop()
+{
+	static unsigned long lastReport = 0;
+
+	if (millis() - lastReport < REPORT_INTERVAL_MS)
+		return;
+
+	lastReport = millis();
+
+	timer_stats_t stats;
+
+	ITimer1.getStats(stats);
+	ITimer1.resetStats();
+	printStats(F("ITimer1"), stats, ITimer1.getClockFrequency());
+
+	ISR_timer.getStats(fastTimer, stats);
+	ISR_timer.resetStats(fastTimer);
+	printStats(F("ISR_Timer fast"), stats, ISR_timer.getUnitsPerSecond());
+
+	ISR_timer.getStats(slowTimer, stats);
+	ISR_timer.resetStats(slowTimer);
+	printStats(F("ISR_Timer slow"), stats, ISR_timer.getUnitsPerSecond());
+}
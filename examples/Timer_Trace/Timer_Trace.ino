@@ -0,0 +1,140 @@
+/****************************************************************************************************************************
+  Timer_Trace.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Now with we can use these new 16 ISR-based timers, while consuming only 1 hwarware Timer.
+  Their independently-selected, maximum interval is practically unlimited (limited only by unsigned long miliseconds)
+  The accuracy is nearly perfect compared to software timers. The most important feature is they're ISR-based timers
+  Therefore, their executions are not blocked by bad-behaving functions / tasks.
+  This important feature is absolutely necessary for mission-critical tasks.
+*****************************************************************************************************************************/
+/* Trace points recorded from the ISRs into the RAM ring of TimerInterrupt_Generic_Debug.h, then printed from loop().
+   The library traces each ISR and callback (TISR_TRACE_LEVEL 4) and the end of a timer with duration (level 2).
+   The callback adds its own records, timestamped by ITimeStamp3 in 1/16 us.
+   With TRACE_BINARY_DUMP, the records are sent in binary by TISR_traceDump(). Capture the Serial port raw and convert
+   it into a timeline with extras/TimerTrace/tisr_trace.py, see there.
+*/
+
+#if !( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
+      defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
+      defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
+      defined(ARDUINO_AVR_ATmega809) || defined(ARDUINO_AVR_ATmega808) )
+#error This is designed only for Arduino or MegaCoreX megaAVR board! Please check your Tools->Board setting
+#endif
+
+// These define's must be placed at the beginning before #include "megaAVR_TimerInterrupt.h"
+// _TIMERINTERRUPT_LOGLEVEL_ from 0 to 4
+// Don't define _TIMERINTERRUPT_LOGLEVEL_ > 0. Only for special ISR debugging only. Can hang the system.
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+// TISR_TRACE_LEVEL from 0 to 4. Safe in ISRs, the records are only printed by TISR_tracePrint()
+#define TISR_TRACE_LEVEL              4
+#define TISR_TRACE_SIZE               64
+
+// Defined below, once ITimeStamp3 exists
+uint32_t traceClock();
+#define TISR_TRACE_CLOCK()            traceClock()
+#define TISR_TRACE_CLOCK_HZ           16000000UL
+
+// true to send binary frames for tisr_trace.py, instead of text
+#define TRACE_BINARY_DUMP             false
+
+#define USING_16MHZ     true
+#define USING_8MHZ      false
+#define USING_250KHZ    false
+
+#define USE_TIMER_1               true
+#define USE_TIMER_2               true
+#define USE_TIMESTAMP_TIMER_3     true
+
+// To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_TimeStamp.h"
+
+#define TIMER1_INTERVAL_MS        100L
+#define TIMER2_INTERVAL_MS        250L
+#define TIMER2_DURATION_MS        2000L
+
+#define PRINT_INTERVAL_MS         500L
+
+// Application events, from TISR_TRACE_USER
+#define TRACE_TIMER1              (TISR_TRACE_USER + 0)
+#define TRACE_TIMER2              (TISR_TRACE_USER + 1)
+
+uint32_t traceClock()
+{
+	return ITimeStamp3.now();
+}
+
+void TimerHandler1()
+{
+	static uint16_t count = 0;
+
+	TISR_TRACEINFO(TRACE_TIMER1, 1, millis(), ++count);
+}
+
+void TimerHandler2()
+{
+	static uint16_t count = 0;
+
+	TISR_TRACEINFO(TRACE_TIMER2, 2, millis(), ++count);
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	while (!Serial);
+
+	Serial.print(F("\nStarting Timer_Trace on "));
+	Serial.println(BOARD_NAME);
+	Serial.println(MEGA_AVR_TIMER_INTERRUPT_VERSION);
+	Serial.print(F("CPU Frequency = "));
+	Serial.print(F_CPU / 1000000);
+	Serial.println(F(" MHz"));
+
+	ITimeStamp3.begin(TCB_CLKSEL_CLKDIV1_gc);
+
+	ITimer1.init();
+
+	if (ITimer1.attachInterruptInterval(TIMER1_INTERVAL_MS, TimerHandler1))
+	{
+		Serial.print(F("Starting  ITimer1 OK, millis() = "));
+		Serial.println(millis());
+	}
+	else
+		Serial.println(F("Can't set ITimer1. Select another freq. or timer"));
+
+	ITimer2.init();
+
+	// Traces TISR_TRACE_TIMER_DONE after TIMER2_DURATION_MS
+	if (ITimer2.attachInterruptInterval(TIMER2_INTERVAL_MS, TimerHandler2, TIMER2_DURATION_MS))
+	{
+		Serial.print(F("Starting  ITimer2 OK, millis() = "));
+		Serial.println(millis());
+	}
+	else
+		Serial.println(F("Can't set ITimer2. Select another freq. or timer"));
+}
+
+void loop()
+{
+	static unsigned long lastPrint = 0;
+
+	if (millis() - lastPrint < PRINT_INTERVAL_MS)
+		return;
+
+	lastPrint = millis();
+
+#if TRACE_BINARY_DUMP
+	TISR_traceDump();
+#else
+	// Time in 1/16 us, then TCB, event, arg0, arg1
+	TISR_tracePrint();
+#endif
+}
@@ -0,0 +1,802 @@
+/****************************************************************************************************************************
+  HostSim.cpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host simulation of TCB0..TCB3, their ISRs and the Arduino API, see include/HostSim.h.
+  Also the host main(), calling setup() then loop(), unless built with HOST_SIM_NO_MAIN.
+*****************************************************************************************************************************/
+
+#include <stdio.h>
+
+#include "Arduino.h"
+
+TCB_t     HostSim_TCB[4];
+EVSYS_t   EVSYS;
+PORTMUX_t PORTMUX;
+ADC_t     ADC0;
+
+// As after reset of the megaAVR core : interrupts enabled
+volatile uint8_t SREG = CPU_I_bm;
+
+HostSerial Serial;
+
+// Vectors of the ISRs, NULL unless defined by the sketch or the library
+extern "C" void TCB0_INT_vect(void) __attribute__((weak));
+extern "C" void TCB1_INT_vect(void) __attribute__((weak));
+extern "C" void TCB2_INT_vect(void) __attribute__((weak));
+extern "C" void TCB3_INT_vect(void) __attribute__((weak));
+extern "C" void ADC0_RESRDY_vect(void) __attribute__((weak));
+
+#define HOST_SIM_NUM_PINS     32
+
+namespace
+{
+  TCB_t* const tcbs[HOST_SIM_NUM_TCB]             = { &TCB0, &TCB1, &TCB2, &TCB3 };
+  void (* const vectors[HOST_SIM_NUM_TCB])(void)  = { TCB0_INT_vect, TCB1_INT_vect, TCB2_INT_vect, TCB3_INT_vect };
+
+  uint64_t  cycles      = 0;
+  uint64_t  endCycles   = UINT64_MAX;
+  uint32_t  isrCycles   = 0;
+  bool      inISR       = false;
+
+  uint32_t  isrCount[HOST_SIM_NUM_TCB];
+
+  // Event input of each TCB, before TCB_EDGE_bm
+  uint8_t   eventLevel[HOST_SIM_NUM_TCB];
+
+  // Capture sequence of the FRQPW mode : waiting for the first edge, input high, input low, done until CAPT cleared
+  enum { FRQPW_IDLE, FRQPW_HIGH, FRQPW_LOW, FRQPW_DONE };
+
+  uint8_t   frqpwState[HOST_SIM_NUM_TCB];
+
+  // ADC0 conversion running, on channel, until cycle adcDoneAt
+  bool      adcBusy     = false;
+  uint8_t   adcChannel;
+  uint64_t  adcDoneAt;
+
+  // ADC0 as set by the megaAVR core before setup() : enabled, 10-bit, CLK_PER / 128
+  struct AdcInit
+  {
+    AdcInit()
+    {
+      ADC0.CTRLA = ADC_ENABLE_bm | ADC_RESSEL_10BIT_gc;
+      ADC0.CTRLC = ADC_PRESC_DIV128_gc;
+    }
+  } adcInit;
+
+  uint8_t   pinLevel[HOST_SIM_NUM_PINS];
+  int       analogValue[HOST_SIM_NUM_PINS];
+  void      (*pinHandler[HOST_SIM_NUM_PINS])(void);
+  int       pinMode_[HOST_SIM_NUM_PINS];
+  bool      pinPending[HOST_SIM_NUM_PINS];
+
+  // CPU cycles per TCB tick
+  uint32_t divOf(const TCB_t& tcb)
+  {
+    switch (tcb.CTRLA & TCB_CLKSEL_gm)
+    {
+      case TCB_CLKSEL_CLKDIV1_gc:
+        return 1;
+
+      case TCB_CLKSEL_CLKDIV2_gc:
+        return 2;
+
+      default:
+        return HOST_SIM_TCA_DIV;
+    }
+  }
+
+  bool isCounting(const TCB_t& tcb)
+  {
+    if ( !(tcb.CTRLA & TCB_ENABLE_bm) )
+      return false;
+
+    switch (tcb.CTRLB & TCB_CNTMODE_gm)
+    {
+      // Single shot : from the event to CCMP only
+      case TCB_CNTMODE_SINGLE_gc:
+        return (tcb.STATUS & TCB_RUN_bm);
+
+      // Frequency and pulse width : from the first rising edge to the second one
+      case TCB_CNTMODE_FRQPW_gc:
+        return (frqpwState[&tcb - tcbs[0]] == FRQPW_HIGH) || (frqpwState[&tcb - tcbs[0]] == FRQPW_LOW);
+
+      default:
+        return true;
+    }
+  }
+
+  // Ticks until the next tick setting CAPT, 0 if none
+  uint32_t ticksToMatch(const TCB_t& tcb)
+  {
+    switch (tcb.CTRLB & TCB_CNTMODE_gm)
+    {
+      case TCB_CNTMODE_INT_gc:
+        // After CNT == CCMP, the next tick restarts from 0. Past CCMP, CNT first wraps at 0xFFFF
+        return (tcb.CNT <= tcb.CCMP) ? tcb.CCMP - tcb.CNT + 1 : 0x10000UL - tcb.CNT + tcb.CCMP + 1;
+
+      case TCB_CNTMODE_PWM8_gc:
+        return (tcb.CNTL <= tcb.CCMPL) ? tcb.CCMPL - tcb.CNTL + 1 : 0x100UL - tcb.CNTL + tcb.CCMPL + 1;
+
+      case TCB_CNTMODE_SINGLE_gc:
+        return (tcb.CNT < tcb.CCMP) ? tcb.CCMP - tcb.CNT : 0x10000UL - tcb.CNT + tcb.CCMP;
+
+      default:
+        return 0;
+    }
+  }
+
+  // ticks is at most ticksToMatch(). Return true on the match, i.e. the CAPT event of the TCB
+  bool count(TCB_t& tcb, const uint32_t& ticks, const uint32_t& toMatch)
+  {
+    if ( (toMatch == 0) || (ticks < toMatch) )
+    {
+      if ( (tcb.CTRLB & TCB_CNTMODE_gm) == TCB_CNTMODE_PWM8_gc )
+        tcb.CNTL = (uint8_t) (tcb.CNTL + ticks);
+      else
+        tcb.CNT  = (uint16_t) (tcb.CNT + ticks);
+
+      return false;
+    }
+
+    switch (tcb.CTRLB & TCB_CNTMODE_gm)
+    {
+      case TCB_CNTMODE_PWM8_gc:
+        tcb.CNTL = 0;
+        break;
+
+      case TCB_CNTMODE_SINGLE_gc:
+        tcb.CNT     = tcb.CCMP;
+        tcb.STATUS &= ~TCB_RUN_bm;
+        break;
+
+      default:
+        tcb.CNT = 0;
+        break;
+    }
+
+    tcb.INTFLAGS.value |= TCB_CAPT_bm;
+
+    return true;
+  }
+
+  // CPU cycles of an ADC0 conversion : 13 ADC clocks at 10-bit (11 at 8-bit), plus SAMPCTRL.SAMPLEN sampling and
+  // CTRLD.SAMPDLY delay clocks (15 with CTRLD.ASDV, the worst case), at CLK_PER / (2 << CTRLC.PRESC)
+  uint32_t adcConversionCycles()
+  {
+    uint32_t adcClocks = ( (ADC0.CTRLA & ADC_RESSEL_bm) ? 11 : 13 ) + (ADC0.SAMPCTRL & ADC_SAMPLEN_gm) +
+                         ( (ADC0.CTRLD & ADC_ASDV_bm) ? ADC_SAMPDLY_gm : (ADC0.CTRLD & ADC_SAMPDLY_gm) );
+
+    return adcClocks * (2UL << (ADC0.CTRLC & ADC_PRESC_gm));
+  }
+
+  // Start event of ADC0. Ignored while a conversion runs, as on the chip
+  void adcStart()
+  {
+    if ( !(ADC0.CTRLA & ADC_ENABLE_bm) || !(ADC0.EVCTRL & ADC_STARTEI_bm) || adcBusy )
+      return;
+
+    adcBusy     = true;
+    adcChannel  = ADC0.MUXPOS & 0x1F;
+    adcDoneAt   = cycles + adcConversionCycles();
+  }
+
+  void adcDone()
+  {
+    int value = (adcChannel < HOST_SIM_NUM_PINS) ? analogValue[adcChannel] : 0;
+    int max   = (ADC0.CTRLA & ADC_RESSEL_bm) ? 255 : 1023;
+
+    ADC0.RES.value        = (value < 0) ? 0 : ( (value > max) ? max : value );
+    ADC0.INTFLAGS.value  |= ADC_RESRDY_bm;
+    adcBusy               = false;
+  }
+
+  // Event of generator, e.g. EVSYS_GENERATOR_TCB1_CAPT_gc, to the users of the EVSYS channels it drives
+  void generate(const uint8_t& generator)
+  {
+    for (uint8_t channel = 0; channel < 8; channel++)
+    {
+      if ( (&EVSYS.CHANNEL0)[channel] != generator )
+        continue;
+
+      if (EVSYS.USERADC0 == channel + 1)
+        adcStart();
+
+      for (uint8_t i = 0; i < HOST_SIM_NUM_TCB; i++)
+      {
+        if ( (&EVSYS.USERTCB0)[i] == channel + 1 )
+          HostSim_event(i);
+      }
+    }
+  }
+
+  void serve();
+
+  // Move all timers to the cycle target, one compare match at a time, so that its ISR runs at its time
+  void countTo(const uint64_t& target)
+  {
+    while (cycles < target)
+    {
+      uint64_t next = target;
+      uint32_t toMatch[HOST_SIM_NUM_TCB];
+
+      for (uint8_t i = 0; i < HOST_SIM_NUM_TCB; i++)
+      {
+        toMatch[i] = isCounting(*tcbs[i]) ? ticksToMatch(*tcbs[i]) : 0;
+
+        if (toMatch[i] != 0)
+        {
+          uint32_t div      = divOf(*tcbs[i]);
+          uint64_t matchAt  = (cycles / div + toMatch[i]) * div;
+
+          if (matchAt < next)
+            next = matchAt;
+        }
+      }
+
+      if (adcBusy && (adcDoneAt < next))
+        next = adcDoneAt;
+
+      bool matched[HOST_SIM_NUM_TCB] = { false };
+
+      for (uint8_t i = 0; i < HOST_SIM_NUM_TCB; i++)
+      {
+        if (isCounting(*tcbs[i]))
+        {
+          uint32_t div = divOf(*tcbs[i]);
+
+          matched[i] = count(*tcbs[i], (uint32_t) (next / div - cycles / div), toMatch[i]);
+        }
+      }
+
+      cycles = next;
+
+      if (adcBusy && (cycles >= adcDoneAt))
+        adcDone();
+
+      for (uint8_t i = 0; i < HOST_SIM_NUM_TCB; i++)
+      {
+        if (matched[i])
+          generate(EVSYS_GENERATOR_TCB0_CAPT_gc + 2 * i);
+      }
+
+      serve();
+    }
+  }
+
+  void callISR(void (*isr)(void))
+  {
+    inISR = true;
+    SREG &= ~CPU_I_bm;
+
+    countTo(cycles + isrCycles);
+
+    isr();
+
+    SREG |= CPU_I_bm;
+    inISR = false;
+  }
+
+  // Pending pin and TCB interrupts, in vector order
+  void serve()
+  {
+    while ( (SREG & CPU_I_bm) && !inISR )
+    {
+      bool served = false;
+
+      for (uint8_t pin = 0; (pin < HOST_SIM_NUM_PINS) && !served; pin++)
+      {
+        if (pinPending[pin])
+        {
+          pinPending[pin] = false;
+
+          if (pinHandler[pin] != NULL)
+            callISR(pinHandler[pin]);
+
+          served = true;
+        }
+      }
+
+      for (uint8_t i = 0; (i < HOST_SIM_NUM_TCB) && !served; i++)
+      {
+        TCB_t& tcb = *tcbs[i];
+
+        // ADC0_RESRDY_vect is between the vectors of TCB1 and TCB2
+        if ( (i == 2) && (ADC0_RESRDY_vect != NULL) && (ADC0.INTCTRL & ADC_RESRDY_bm) &&
+             (ADC0.INTFLAGS.value & ADC_RESRDY_bm) )
+        {
+          callISR(ADC0_RESRDY_vect);
+
+          served = true;
+          break;
+        }
+
+        if ( (vectors[i] != NULL) && (tcb.INTCTRL & TCB_CAPT_bm) && (tcb.INTFLAGS.value & TCB_CAPT_bm) )
+        {
+          isrCount[i]++;
+
+          callISR(vectors[i]);
+
+          served = true;
+        }
+      }
+
+      if (!served)
+        return;
+    }
+  }
+
+  void checkTimeLimit()
+  {
+    if ( (cycles >= endCycles) && !inISR )
+    {
+      fflush(stdout);
+      exit(0);
+    }
+  }
+}   // namespace
+
+////////////////////////////////////////////////////////
+
+void HostSim_advance(const uint64_t& delta)
+{
+  serve();
+
+  countTo(cycles + delta);
+
+  checkTimeLimit();
+}
+
+void HostSim_readFlags()
+{
+  countTo(cycles + 1);
+}
+
+uint16_t HostSim_readADCResult()
+{
+  ADC0.INTFLAGS.value &= ~ADC_RESRDY_bm;
+
+  return ADC0.RES.value;
+}
+
+uint64_t HostSim_cycles()
+{
+  return cycles;
+}
+
+void HostSim_setISRCycles(const uint32_t& n)
+{
+  isrCycles = n;
+}
+
+uint32_t HostSim_getISRCount(const uint8_t& timerNo)
+{
+  return (timerNo < HOST_SIM_NUM_TCB) ? isrCount[timerNo] : 0;
+}
+
+void HostSim_setEvent(const uint8_t& timerNo, const uint8_t& level)
+{
+  if (timerNo >= HOST_SIM_NUM_TCB)
+    return;
+
+  TCB_t& tcb = *tcbs[timerNo];
+
+  uint8_t previous = eventLevel[timerNo];
+
+  eventLevel[timerNo] = (level != 0);
+
+  if ( !(tcb.CTRLA & TCB_ENABLE_bm) || !(tcb.EVCTRL & TCB_CAPTEI_bm) || (previous == eventLevel[timerNo]) )
+    return;
+
+  // TCB_EDGE_bm inverts the input : rising is then the falling edge of the event
+  bool rising = ( eventLevel[timerNo] != 0 ) != ( (tcb.EVCTRL & TCB_EDGE_bm) != 0 );
+
+  switch (tcb.CTRLB & TCB_CNTMODE_gm)
+  {
+    case TCB_CNTMODE_SINGLE_gc:
+      if ( rising && !(tcb.STATUS & TCB_RUN_bm) )
+      {
+        tcb.CNT     = 0;
+        tcb.STATUS |= TCB_RUN_bm;
+      }
+
+      break;
+
+    // Rising edge : count captured
+    case TCB_CNTMODE_CAPT_gc:
+      if (rising)
+      {
+        tcb.CCMP = tcb.CNT;
+        tcb.INTFLAGS.value |= TCB_CAPT_bm;
+      }
+
+      break;
+
+    // Rising edge : period captured, count restarted
+    case TCB_CNTMODE_FRQ_gc:
+      if (rising)
+      {
+        tcb.CCMP = tcb.CNT;
+        tcb.CNT  = 0;
+        tcb.INTFLAGS.value |= TCB_CAPT_bm;
+      }
+
+      break;
+
+    // Rising edge restarts the count, falling edge captures the pulse width
+    case TCB_CNTMODE_PW_gc:
+      if (rising)
+      {
+        tcb.CNT = 0;
+      }
+      else
+      {
+        tcb.CCMP = tcb.CNT;
+        tcb.INTFLAGS.value |= TCB_CAPT_bm;
+      }
+
+      break;
+
+    // Rising edge starts the count, falling edge captures the pulse width into CCMP, next rising edge stops the
+    // count, CNT holding the period, and sets CAPT. Then a new sequence once CAPT is cleared
+    case TCB_CNTMODE_FRQPW_gc:
+      if ( (frqpwState[timerNo] == FRQPW_DONE) && !(tcb.INTFLAGS.value & TCB_CAPT_bm) )
+        frqpwState[timerNo] = FRQPW_IDLE;
+
+      switch (frqpwState[timerNo])
+      {
+        case FRQPW_IDLE:
+          if (rising)
+          {
+            tcb.CNT             = 0;
+            frqpwState[timerNo] = FRQPW_HIGH;
+          }
+
+          break;
+
+        case FRQPW_HIGH:
+          if (!rising)
+          {
+            tcb.CCMP            = tcb.CNT;
+            frqpwState[timerNo] = FRQPW_LOW;
+          }
+
+          break;
+
+        case FRQPW_LOW:
+          if (rising)
+          {
+            tcb.INTFLAGS.value |= TCB_CAPT_bm;
+            frqpwState[timerNo] = FRQPW_DONE;
+          }
+
+          break;
+
+        default:
+          break;
+      }
+
+      break;
+
+    default:
+      break;
+  }
+
+  serve();
+}
+
+void HostSim_event(const uint8_t& timerNo)
+{
+  if (timerNo >= HOST_SIM_NUM_TCB)
+    return;
+
+  // Pulse of the event input, shorter than a TCB tick
+  HostSim_setEvent(timerNo, !eventLevel[timerNo]);
+  HostSim_setEvent(timerNo, !eventLevel[timerNo]);
+}
+
+void HostSim_strobe(const uint8_t mask)
+{
+  // EVSYS.USERTCBn is the channel used by TCBn + 1, 0 if none
+  for (uint8_t channel = 0; channel < 8; channel++)
+  {
+    if ( !(mask & (1 << channel)) )
+      continue;
+
+    for (uint8_t i = 0; i < HOST_SIM_NUM_TCB; i++)
+    {
+      if ( (&EVSYS.USERTCB0)[i] == channel + 1 )
+        HostSim_event(i);
+    }
+  }
+}
+
+void HostSim_setPin(const uint8_t& pin, const uint8_t& level)
+{
+  if (pin >= HOST_SIM_NUM_PINS)
+    return;
+
+  uint8_t previous = pinLevel[pin];
+
+  pinLevel[pin] = level;
+
+  if ( (pinHandler[pin] == NULL) || (previous == level) )
+    return;
+
+  int mode = pinMode_[pin];
+
+  if ( (mode == CHANGE) || ( (mode == RISING) && level ) || ( (mode == FALLING) && !level ) )
+  {
+    pinPending[pin] = true;
+
+    serve();
+  }
+}
+
+void HostSim_setAnalog(const uint8_t& pin, const int& value)
+{
+  if (pin < HOST_SIM_NUM_PINS)
+    analogValue[pin] = value;
+}
+
+void HostSim_setTimeLimit(const double& seconds)
+{
+  endCycles = (uint64_t) (seconds * F_CPU);
+}
+
+void HostSim_sei()
+{
+  SREG |= CPU_I_bm;
+
+  serve();
+}
+
+void HostSim_cli()
+{
+  SREG &= ~CPU_I_bm;
+}
+
+////////////////////////////////////////////////////////
+
+unsigned long millis()
+{
+  if (!inISR)
+    HostSim_advance(HOST_SIM_POLL_CYCLES);
+
+  return (unsigned long) ( cycles / (F_CPU / 1000UL) );
+}
+
+unsigned long micros()
+{
+  if (!inISR)
+    HostSim_advance(HOST_SIM_POLL_CYCLES);
+
+  return (unsigned long) ( cycles / (F_CPU / 1000000UL) );
+}
+
+void delay(unsigned long ms)
+{
+  HostSim_advance( (uint64_t) ms * (F_CPU / 1000UL) );
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  // Busy loop. In an ISR, it delays the other interrupts
+  HostSim_advance( (uint64_t) us * (F_CPU / 1000000UL) );
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if ( (pin < HOST_SIM_NUM_PINS) && (mode == INPUT_PULLUP) )
+    pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin < HOST_SIM_NUM_PINS)
+    pinLevel[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+  return (pin < HOST_SIM_NUM_PINS) ? pinLevel[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  // A0..A7 or channel number
+  if ( (pin >= PIN_A0) && (pin < PIN_A0 + NUM_ANALOG_INPUTS) )
+    pin -= PIN_A0;
+
+  return (pin < HOST_SIM_NUM_PINS) ? analogValue[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  digitalWrite(pin, (value >= 128) ? HIGH : LOW);
+}
+
+int digitalPinToInterrupt(uint8_t pin)
+{
+  return (pin < HOST_SIM_NUM_PINS) ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode)
+{
+  if (interruptNum < HOST_SIM_NUM_PINS)
+  {
+    pinHandler[interruptNum] = userFunc;
+    pinMode_[interruptNum]   = mode;
+  }
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+  if (interruptNum < HOST_SIM_NUM_PINS)
+    pinHandler[interruptNum] = NULL;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(long howbig)
+{
+  return (howbig <= 0) ? 0 : rand() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+  return (howsmall >= howbig) ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+  srand((unsigned int) seed);
+}
+
+////////////////////////////////////////////////////////
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+  size_t n = 0;
+
+  while (size--)
+    n += write(*buffer++);
+
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper* str)
+{
+  return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char* str)
+{
+  return write(str);
+}
+
+size_t Print::print(char c)
+{
+  return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::print(int n, int base)
+{
+  return print((long long) n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+  return print((long long) n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::print(long long n, int base)
+{
+  // Negative numbers are printed signed in base 10 only, as by the Arduino core
+  if ( (n < 0) && (base == DEC) )
+    return write('-') + printNumber( (unsigned long long) -n, base);
+
+  return printNumber( (unsigned long long) n, base);
+}
+
+size_t Print::print(unsigned long long n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+  char buffer[64];
+
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+
+  return write(buffer);
+}
+
+size_t Print::println()
+{
+  return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long long n, int base)
+{
+  char  buffer[8 * sizeof(n) + 1];
+  char* str = &buffer[sizeof(buffer) - 1];
+
+  if (base < 2)
+    base = DEC;
+
+  *str = '\0';
+
+  do
+  {
+    char digit = (char) (n % base);
+    n /= base;
+
+    *--str = (digit < 10) ? digit + '0' : digit + 'A' - 10;
+  } while (n);
+
+  return write(str);
+}
+
+void HostSerial::flush()
+{
+  fflush(stdout);
+}
+
+size_t HostSerial::write(uint8_t c)
+{
+  return (fputc(c, stdout) == EOF) ? 0 : 1;
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size)
+{
+  return fwrite(buffer, 1, size, stdout);
+}
+
+////////////////////////////////////////////////////////
+
+#ifndef HOST_SIM_NO_MAIN
+
+// First argument : virtual run time in seconds
+int main(int argc, char* argv[])
+{
+  HostSim_setTimeLimit( (argc > 1) ? atof(argv[1]) : HOST_SIM_SECONDS );
+
+  setup();
+
+  while (true)
+  {
+    loop();
+
+    HostSim_advance(HOST_SIM_LOOP_CYCLES);
+  }
+
+  return 0;
+}
+
+#endif    // HOST_SIM_NO_MAIN
@@ -0,0 +1,156 @@
+#!/bin/sh
+#
+#  build.sh
+#  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+#
+#  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+#  Licensed under MIT license
+#
+#  Build a sketch of the library for the host simulation (see include/HostSim.h), unmodified, with g++ :
+#
+#    extras/HostSim/build.sh examples/TimerDuration [output]
+#    ./TimerDuration 5              # 5 seconds of virtual time, default HOST_SIM_SECONDS
+#
+#  The argument is the sketch directory or its .ino. Its .cpp files are built too. Variables :
+#    CXX        compiler, default g++
+#    F_CPU      CPU frequency, default 16000000UL (20000000UL for MegaCoreX at 20MHz)
+#    CXXFLAGS   more flags, e.g. -DHOST_SIM_SECONDS=60, or -DHOST_SIM_NO_MAIN to provide your own main()
+#
+#  As with the Arduino IDE, the .ino is compiled as C++ with Arduino.h included first, and with prototypes of its
+#  functions inserted before the first one (#line keeps the messages on the .ino lines). Only one-line
+#  signatures at file level, without default argument or template, get a prototype. Unlike the IDE, libraries
+#  other than this one aren't available : ISR_16_Timers_Array_Complex and ISR_Timers_Array_Simple, using
+#  SimpleTimer, don't build.
+#  Pointers are 64-bit : -no-pie keeps the static data below 4GB, so that sketches passing pointers as
+#  unsigned int callback parameters still work. Of the examples, only Argument_Complex casts these pointers
+#  in a way g++ rejects on the host : it alone is built with -fpermissive, which turns the errors into warnings.
+
+set -e
+
+HOST_SIM_DIR=$(cd "$(dirname "$0")" && pwd)
+LIBRARY_SRC="$HOST_SIM_DIR/../../src"
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <sketch directory or .ino> [output]" >&2
+  exit 1
+fi
+
+if [ -d "$1" ]; then
+  SKETCH_DIR=$(cd "$1" && pwd)
+  SKETCH_INO="$SKETCH_DIR/$(basename "$SKETCH_DIR").ino"
+else
+  SKETCH_DIR=$(cd "$(dirname "$1")" && pwd)
+  SKETCH_INO="$SKETCH_DIR/$(basename "$1")"
+fi
+
+if [ ! -f "$SKETCH_INO" ]; then
+  echo "$0: $SKETCH_INO not found" >&2
+  exit 1
+fi
+
+OUTPUT=${2:-./$(basename "$SKETCH_INO" .ino)}
+
+# Sketches whose pointer to unsigned int casts only build with -fpermissive on a 64-bit host
+case "$(basename "$SKETCH_INO" .ino)" in
+  Argument_Complex)
+    PERMISSIVE=-fpermissive
+    ;;
+  *)
+    PERMISSIVE=
+    ;;
+esac
+
+# The .ino with the prototypes of its functions, as generated by the IDE
+SKETCH_CPP_INO=$(mktemp "${TMPDIR:-/tmp}/HostSim.XXXXXX")
+trap 'rm -f "$SKETCH_CPP_INO"' EXIT
+
+awk -v ino="$SKETCH_INO" '
+  function strip(line)
+  {
+    gsub(/"([^"\\]|\\.)*"/, "\"\"", line)
+    gsub(/\047([^\047\\]|\\.)*\047/, "0", line)
+    sub(/\/\/.*/, "", line)
+    return line
+  }
+
+  {
+    lines[NR] = $0
+    code = $0
+
+    # Block comments
+    if (inComment)
+    {
+      if (index(code, "*/") == 0)
+        next
+
+      code = substr(code, index(code, "*/") + 2)
+      inComment = 0
+    }
+
+    code = strip(code)
+
+    while (match(code, /\/\*/))
+    {
+      rest = substr(code, RSTART + 2)
+
+      if (index(rest, "*/") == 0)
+      {
+        code = substr(code, 1, RSTART - 1)
+        inComment = 1
+        break
+      }
+
+      code = substr(code, 1, RSTART - 1) " " substr(rest, index(rest, "*/") + 2)
+    }
+
+    # Function definition at file level : type name(params), then { on this or the next line
+    if ( (depth == 0) && (code ~ /^[A-Za-z_][A-Za-z0-9_:<>,*& \t]*[*& \t]+[A-Za-z_][A-Za-z0-9_]*[ \t]*\([^;=]*\)[ \t]*\{?[ \t]*$/) &&
+         (code !~ /^(else|return|typedef|struct|class|enum|union|namespace|template|using|static_assert)[^A-Za-z0-9_]/) )
+      candidate = NR
+    else if (candidate && (code !~ /^[ \t]*(\{.*)?$/))
+      candidate = 0
+
+    if (candidate && (index(code, "{") > 0))
+    {
+      signature = strip(lines[candidate])
+      sub(/[ \t]*\{.*$/, "", signature)
+      prototypes = prototypes signature ";\n"
+
+      if (!first)
+        first = candidate
+
+      candidate = 0
+    }
+
+    depth += gsub(/\{/, "{", code) - gsub(/\}/, "}", code)
+  }
+
+  END {
+    if (!first)
+      first = NR + 1
+
+    printf "#line 1 \"%s\"\n", ino
+
+    for (i = 1; i <= NR; i++)
+    {
+      if (i == first)
+        printf "%s#line %d \"%s\"\n", prototypes, i, ino
+
+      print lines[i]
+    }
+  }
+' "$SKETCH_INO" > "$SKETCH_CPP_INO"
+
+# Other files of a multi-file sketch
+SKETCH_CPP=$(find "$SKETCH_DIR" -maxdepth 1 -name '*.cpp' | sort)
+
+${CXX:-g++} -std=gnu++11 -O1 -g -Wall -no-pie $PERMISSIVE \
+  -D__AVR_ATmega4809__ -DARDUINO_AVR_NANO_EVERY -DARDUINO_ARCH_MEGAAVR -DARDUINO=10819 \
+  -DF_CPU="${F_CPU:-16000000UL}" \
+  -I"$HOST_SIM_DIR/include" -I"$LIBRARY_SRC" -I"$SKETCH_DIR" \
+  $CXXFLAGS \
+  -include Arduino.h \
+  -x c++ "$SKETCH_CPP_INO" -x none $SKETCH_CPP "$HOST_SIM_DIR/HostSim.cpp" \
+  -o "$OUTPUT"
+
+echo "Built $OUTPUT"
@@ -0,0 +1,139 @@
+/****************************************************************************************************************************
+  Capture_FRQPW.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host simulation check of TimerCapture in TCB_CNTMODE_FRQPW_gc mode : each capture must hold the period and the
+  pulse width of the event input, as on the chip (period in CNT, pulse width in CCMP), with the rising and with the
+  inverted (falling) edge. Build and run from the top directory of the library :
+
+    extras/HostSim/build.sh extras/HostSim/checks/Capture_FRQPW
+    ./Capture_FRQPW
+
+  Prints PASS, or FAIL with the first wrong capture, and exits with 1 on FAIL.
+*****************************************************************************************************************************/
+
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_CAPTURE_TIMER_1     true
+
+#include "megaAVR_TimerCapture.h"
+
+#include <stdlib.h>
+
+// CPU cycles per tick of TCB_CLKSEL_CLKTCA_gc
+#define CYCLES_PER_TICK       HOST_SIM_TCA_DIV
+
+#define CAPTURE_EVSYS_CHANNEL     0
+#define CAPTURE_GENERATOR         EVSYS_GENERATOR_PORT0_PIN0_gc
+
+// Waveforms of the event input, in ticks : period and active (pulse) time
+#define NUM_WAVES             3
+
+const uint16_t periods[NUM_WAVES] = { 1000, 250, 40000 };
+const uint16_t actives[NUM_WAVES] = { 300,  125, 1 };
+
+// Periods measured per waveform and edge
+#define PERIODS_PER_WAVE      20
+
+uint32_t captures = 0;
+
+void fail(const char* edge, const uint16_t& period, const uint16_t& active, const capture_t& capture)
+{
+	Serial.print(F("FAIL : "));
+	Serial.print(edge);
+	Serial.print(F(" edge, expected period = "));
+	Serial.print(period);
+	Serial.print(F(", pulse width = "));
+	Serial.print(active);
+	Serial.print(F(", got "));
+	Serial.print(capture.period);
+	Serial.print(F(", "));
+	Serial.println(capture.pulseWidth);
+
+	exit(1);
+}
+
+// Event input of TCB1 at level for ticks
+void drive(const uint8_t& level, const uint16_t& ticks)
+{
+	HostSim_setEvent(HW_TIMER_1, level);
+	HostSim_advance( (uint64_t) ticks * CYCLES_PER_TICK);
+}
+
+void check(const bool& invertEdge)
+{
+	const char* edge = invertEdge ? "falling" : "rising";
+
+	// Active level : high, or low if the edges are inverted
+	uint8_t active = invertEdge ? LOW : HIGH;
+
+	HostSim_setEvent(HW_TIMER_1, !active);
+
+	if (!ICapture1.begin(TCB_CNTMODE_FRQPW_gc, CAPTURE_EVSYS_CHANNEL, CAPTURE_GENERATOR, TCB_CLKSEL_CLKTCA_gc, invertEdge))
+	{
+		Serial.println(F("FAIL : can't start ICapture1"));
+		exit(1);
+	}
+
+	for (uint8_t w = 0; w < NUM_WAVES; w++)
+	{
+		uint32_t count = 0;
+
+		for (uint8_t i = 0; i < PERIODS_PER_WAVE; i++)
+		{
+			drive(active, actives[w]);
+			drive(!active, periods[w] - actives[w]);
+
+			capture_t capture;
+
+			while (ICapture1.read(capture))
+			{
+				// The first capture of a waveform may span the previous one
+				if ( (i > 1) && ( (capture.period != periods[w]) || (capture.pulseWidth != actives[w]) ) )
+					fail(edge, periods[w], actives[w], capture);
+
+				count++;
+			}
+		}
+
+		// A sequence takes one period, then starts again at the next active edge after the capture was read
+		if (count < PERIODS_PER_WAVE / 2 - 1)
+		{
+			Serial.print(F("FAIL : "));
+			Serial.print(edge);
+			Serial.print(F(" edge, only "));
+			Serial.print(count);
+			Serial.print(F(" captures for period = "));
+			Serial.println(periods[w]);
+
+			exit(1);
+		}
+
+		captures += count;
+	}
+
+	ICapture1.end();
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	check(false);
+	check(true);
+
+	Serial.print(F("captures = "));
+	Serial.println(captures);
+	Serial.println(F("PASS"));
+
+	exit(0);
+}
+
+void loop()
+{
+}
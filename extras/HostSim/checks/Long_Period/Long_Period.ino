@@ -0,0 +1,162 @@
+/****************************************************************************************************************************
+  Long_Period.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host simulation check of the split of a period longer than 65536 ticks into segments by set_CCMP() : a 5s period
+  at CLK_PER (16MHz) is 80000000 ticks, i.e. 1221 segments of 65520 ticks (CCMP 65519), the first 80 one tick longer.
+  Checks the segments, CCMP of each segment, ISRs per period, getElapsedTicks() and the callback period, to the cycle.
+  Build and run from the top directory of the library :
+
+    extras/HostSim/build.sh extras/HostSim/checks/Long_Period
+    ./Long_Period
+
+  Prints PASS, or FAIL with the first wrong value, and exits with 1 on FAIL. Only for F_CPU 16MHz.
+*****************************************************************************************************************************/
+
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "megaAVR_TimerInterrupt.h"
+
+#include <stdlib.h>
+
+#if (F_CPU != 16000000UL)
+  #error Long_Period expects F_CPU 16MHz
+#endif
+
+#define PERIOD_MS             5000UL
+
+// At CLK_PER, one tick per CPU cycle
+#define PERIOD_TICKS          ( PERIOD_MS * (F_CPU / 1000) )
+#define SEGMENTS              1221
+#define SEGMENT_CCMP          65519
+#define LONG_SEGMENTS         80
+
+// Callbacks checked, after the first one, which ends a period started before setInterval()
+#define NUM_PERIODS           8
+
+// ISR latency, constant, so that the callback period stays exact
+#define ISR_CYCLES            50
+
+// getElapsedTicks() against the cycles : the INTFLAGS read of getElapsedTicks() takes a cycle
+#define MAX_ELAPSED_ERROR     2
+
+volatile uint32_t callbacks       = 0;
+volatile uint64_t lastCallback    = 0;
+volatile uint32_t lastISRCount    = 0;
+
+uint32_t          ccmpChecks      = 0;
+
+void fail(const __FlashStringHelper* what, const long long& expected, const long long& got)
+{
+	Serial.print(F("FAIL : "));
+	Serial.print(what);
+	Serial.print(F(", expected "));
+	Serial.print(expected);
+	Serial.print(F(", got "));
+	Serial.println(got);
+
+	exit(1);
+}
+
+void TimerHandler()
+{
+	uint64_t now      = HostSim_cycles();
+	uint32_t isrCount = HostSim_getISRCount(HW_TIMER_1);
+
+	if (callbacks > 0)
+	{
+		if (now - lastCallback != PERIOD_TICKS)
+			fail(F("callback period (cycles)"), PERIOD_TICKS, now - lastCallback);
+
+		if (isrCount - lastISRCount != SEGMENTS)
+			fail(F("ISRs per period"), SEGMENTS, isrCount - lastISRCount);
+	}
+
+	lastCallback = now;
+	lastISRCount = isrCount;
+	callbacks++;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	HostSim_setTimeLimit( (NUM_PERIODS + 2) * PERIOD_MS / 1000.0 );
+	HostSim_setISRCycles(ISR_CYCLES);
+
+	ITimer1.init();
+	ITimer1.setClockSource(TCB_CLKSEL_CLKDIV1_gc);
+
+	if (!ITimer1.attachInterruptInterval(PERIOD_MS, TimerHandler))
+	{
+		Serial.println(F("FAIL : can't set ITimer1"));
+		exit(1);
+	}
+
+	if (ITimer1.get_CCMPValue() != PERIOD_TICKS)
+		fail(F("ticks"), PERIOD_TICKS, ITimer1.get_CCMPValue());
+
+	if (ITimer1.getSegments() != SEGMENTS)
+		fail(F("segments"), SEGMENTS, ITimer1.getSegments());
+
+	if (TCB1.CCMP != SEGMENT_CCMP + 1)
+		fail(F("CCMP of the first segment"), SEGMENT_CCMP + 1, TCB1.CCMP);
+}
+
+void loop()
+{
+	noInterrupts();
+
+	uint16_t done     = ITimer1.getSegmentsDone();
+	uint16_t ccmp     = TCB1.CCMP;
+	bool     pending  = (TCB1.INTFLAGS.value & TCB_CAPT_bm);
+	uint64_t now      = HostSim_cycles();
+	uint32_t elapsed  = ITimer1.getElapsedTicks();
+	uint32_t periods  = callbacks;
+	uint64_t start    = lastCallback - ISR_CYCLES;
+
+	interrupts();
+
+	// CCMP of the segment running, unless its end is not served yet
+	if (!pending)
+	{
+		uint16_t expected = (done < LONG_SEGMENTS) ? SEGMENT_CCMP + 1 : SEGMENT_CCMP;
+
+		if (ccmp != expected)
+			fail(F("CCMP of the segment"), expected, ccmp);
+
+		ccmpChecks++;
+	}
+
+	// Period start known after the first callback, run ISR_CYCLES after it
+	if (periods > 0)
+	{
+		long long error = (long long) elapsed - (long long) (now - start);
+
+		if (llabs(error) > MAX_ELAPSED_ERROR)
+			fail(F("getElapsedTicks() - cycles since the period start"), 0, error);
+	}
+
+	if (periods > NUM_PERIODS)
+	{
+		Serial.print(F("periods = "));
+		Serial.print(periods - 1);
+		Serial.print(F(", ISRs = "));
+		Serial.print(HostSim_getISRCount(HW_TIMER_1));
+		Serial.print(F(", CCMP checks = "));
+		Serial.println(ccmpChecks);
+		Serial.println(F("PASS"));
+
+		exit(0);
+	}
+
+	// Loop polls at every phase of the segments
+	HostSim_advance(997 + (rand() % 6000));
+}
@@ -0,0 +1,143 @@
+/****************************************************************************************************************************
+  Tickless_Drift.ino
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host simulation check of the tickless ISR_Timer : now() must follow the TCB clock, i.e. HostSim_cycles() / 64,
+  whatever the ISR latency (below ISR_TIMER_TICKLESS_MIN_CYCLES), the length of the callbacks and the timers set
+  or changed from loop() meanwhile. Build and run from the top directory of the library :
+
+    extras/HostSim/build.sh extras/HostSim/checks/Tickless_Drift
+    ./Tickless_Drift
+
+  Prints PASS, or FAIL with the worst drift, at the end of the run, and exits with 1 on FAIL.
+*****************************************************************************************************************************/
+
+#define TIMER_INTERRUPT_DEBUG         0
+#define _TIMERINTERRUPT_LOGLEVEL_     0
+
+#define USE_TIMER_1     true
+
+#include "megaAVR_TimerInterrupt.h"
+#include "megaAVR_ISR_Timer.h"
+
+#include <stdlib.h>
+
+// CPU cycles per tick of TCB_CLKSEL_CLKTCA_gc
+#define CYCLES_PER_TICK       HOST_SIM_TCA_DIV
+
+// Latency from the compare match to the ISR, below ISR_TIMER_TICKLESS_MIN_CYCLES
+#define ISR_CYCLES            600
+
+// Ticks of now() off the TCB clock accepted : the TCB phase at attachTickless()
+#define MAX_DRIFT_TICKS       1
+
+ISR_Timer ISR_timer;
+
+uint64_t startCycles;
+
+uint32_t fastCount  = 0;
+uint32_t slowCount  = 0;
+uint32_t oneCount   = 0;
+uint32_t checks     = 0;
+long     maxDrift   = 0;
+
+int      changedTimer;
+
+// now() being the time run() started, until the next loop()
+bool     slowRan    = false;
+
+void checkNow()
+{
+	if (slowRan)
+		return;
+
+	long drift = (long) (ISR_timer.now() - (unsigned long) ( (HostSim_cycles() - startCycles) / CYCLES_PER_TICK) );
+
+	if (labs(drift) > labs(maxDrift))
+		maxDrift = drift;
+
+	checks++;
+}
+
+// Shorter than the min ticks, served as fast as possible
+void fast()
+{
+	fastCount++;
+	checkNow();
+}
+
+// Longer than a TCB wrap, so that CNT wraps during the callbacks
+void slow()
+{
+	slowCount++;
+	checkNow();
+
+	HostSim_advance(70000UL * CYCLES_PER_TICK);
+
+	slowRan = true;
+}
+
+void once()
+{
+	oneCount++;
+	checkNow();
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	if (!ISR_timer.attachTickless(ITimer1))
+	{
+		Serial.println(F("FAIL : can't start the tickless mode"));
+		exit(1);
+	}
+
+	startCycles = HostSim_cycles();
+
+	HostSim_setISRCycles(ISR_CYCLES);
+
+	ISR_timer.setIntervalTicks(8, fast);
+	ISR_timer.setIntervalTicks(250000UL, slow);
+	changedTimer = ISR_timer.setIntervalTicks(1000, once);
+}
+
+void loop()
+{
+	static uint32_t loops = 0;
+
+	slowRan = false;
+
+	checkNow();
+
+	// Timers set and changed at all phases of the TCB period, for reschedule()
+	if (++loops % 37 == 0)
+	{
+		ISR_timer.changeIntervalTicks(changedTimer, 20 + (rand() % 100000L));
+		ISR_timer.setTimeoutTicks(10 + (rand() % 3000), once);
+	}
+
+	// Report before the end of the default 10s run
+	if (HostSim_cycles() - startCycles >= (uint64_t) 9 * F_CPU)
+	{
+		Serial.print(F("fast = "));
+		Serial.print(fastCount);
+		Serial.print(F(", slow = "));
+		Serial.print(slowCount);
+		Serial.print(F(", once = "));
+		Serial.print(oneCount);
+		Serial.print(F(", checks = "));
+		Serial.print(checks);
+		Serial.print(F(", max drift = "));
+		Serial.print(maxDrift);
+		Serial.println(F(" ticks"));
+
+		Serial.println( (labs(maxDrift) <= MAX_DRIFT_TICKS) ? F("PASS") : F("FAIL") );
+
+		exit( (labs(maxDrift) <= MAX_DRIFT_TICKS) ? 0 : 1 );
+	}
+}
@@ -0,0 +1,189 @@
+/****************************************************************************************************************************
+  Arduino.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host build of the library, see HostSim.h. The part of the Arduino API used by the library and its examples,
+  timed by the virtual clock. Serial prints to stdout.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_ARDUINO_H
+#define HOST_SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "avr/pgmspace.h"
+#include "pins_arduino.h"
+#include "HostSim.h"
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define LOW                   0
+#define HIGH                  1
+
+#define INPUT                 0
+#define OUTPUT                1
+#define INPUT_PULLUP          2
+
+#define CHANGE                4
+#define FALLING               2
+#define RISING                3
+
+#define DEC                   10
+#define HEX                   16
+#define OCT                   8
+#define BIN                   2
+
+#define NOT_AN_INTERRUPT      -1
+
+#define interrupts()          sei()
+#define noInterrupts()        cli()
+
+template<class T, class L>
+auto min(const T& a, const L& b) -> decltype((b < a) ? b : a)
+{
+  return (b < a) ? b : a;
+}
+
+template<class T, class L>
+auto max(const T& a, const L& b) -> decltype((b < a) ? b : a)
+{
+  return (a < b) ? b : a;
+}
+
+template<class T, class L, class H>
+T constrain(const T& x, const L& low, const H& high)
+{
+  return (x < low) ? low : ( (x > high) ? high : x );
+}
+
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+void          yield();
+
+void          pinMode(uint8_t pin, uint8_t mode);
+void          digitalWrite(uint8_t pin, uint8_t value);
+int           digitalRead(uint8_t pin);
+int           analogRead(uint8_t pin);
+void          analogWrite(uint8_t pin, int value);
+
+int           digitalPinToInterrupt(uint8_t pin);
+void          attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void          detachInterrupt(uint8_t interruptNum);
+
+long          map(long x, long in_min, long in_max, long out_min, long out_max);
+long          random(long howbig);
+long          random(long howsmall, long howbig);
+void          randomSeed(unsigned long seed);
+
+////////////////////////////////////////////////////////
+
+class __FlashStringHelper;
+
+#define F(string_literal)     (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+class Print
+{
+  public:
+
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+
+    size_t write(const char* str)
+    {
+      return (str == NULL) ? 0 : write((const uint8_t*) str, strlen(str));
+    }
+
+    size_t print(const __FlashStringHelper* str);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC);
+    size_t print(int n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(long long n, int base = DEC);
+    size_t print(unsigned long long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println();
+
+    template<class T>
+    size_t println(const T& value)
+    {
+      size_t n = print(value);
+      return n + println();
+    }
+
+    template<class T>
+    size_t println(const T& value, int format)
+    {
+      size_t n = print(value, format);
+      return n + println();
+    }
+
+  private:
+
+    size_t printNumber(unsigned long long n, int base);
+};
+
+// Serial, printing to stdout
+class HostSerial : public Print
+{
+  public:
+
+    void begin(unsigned long baud)
+    {
+      (void) baud;
+    }
+
+    void end() {}
+
+    int available()
+    {
+      return 0;
+    }
+
+    int read()
+    {
+      return -1;
+    }
+
+    void flush();
+
+    operator bool()
+    {
+      return true;
+    }
+
+    using Print::write;
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buffer, size_t size);
+};
+
+extern HostSerial Serial;
+
+////////////////////////////////////////////////////////
+
+// Sketch
+void setup();
+void loop();
+
+#endif    // HOST_SIM_ARDUINO_H
@@ -0,0 +1,92 @@
+/****************************************************************************************************************************
+  HostSim.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host simulation of the megaAVR parts used by the library, to build and run the unmodified library and examples
+  on Linux, see build.sh.
+
+  Time is a virtual count of CPU cycles, moved on only by HostSim_advance(), delay(), delayMicroseconds(), by each
+  millis() / micros() call outside ISRs (HOST_SIM_POLL_CYCLES), by each read of a TCB INTFLAGS (one cycle) and
+  between loop() calls (HOST_SIM_LOOP_CYCLES).
+  TCB0..TCB3 count from it with their CLKSEL prescaler, TCA being at F_CPU / HOST_SIM_TCA_DIV:
+  - Periodic interrupt mode: CNT counts up to CCMP, then back to 0 while INTFLAGS.CAPT is set.
+  - 8-bit PWM mode: the same with CNTL and CCMPL.
+  - Single shot mode: started by HostSim_event(), stops and sets CAPT when CNT reaches CCMP.
+    Writing EVSYS.STROBE sends HostSim_event() to each TCB whose EVSYS.USERTCBn selects a strobed channel.
+  - Capture modes, with the edges of the event input given by HostSim_setEvent() (inverted by EVCTRL.EDGE):
+    CAPT and FRQ capture CNT into CCMP on the rising edge (FRQ clearing CNT), PW clears CNT on the rising edge and
+    captures it on the falling one. FRQPW counts from a rising edge, captures the pulse width into CCMP on the
+    falling edge, and stops on the next rising edge with the period in CNT, until CAPT is cleared.
+  Each match (CAPT) of a TCB is also its EVSYS generator event, sent to the TCBs and ADC0 using the channels it drives.
+  ADC0, set as by the core (10-bit, CLK_PER / 128), converts on its start event (EVCTRL.STARTEI), ignored while a
+  conversion runs. A conversion takes 13 ADC clocks (11 at 8-bit) plus SAMPCTRL.SAMPLEN and CTRLD.SAMPDLY, then RES
+  holds the HostSim_setAnalog() value of channel MUXPOS and RESRDY is set, cleared by reading RES.
+  The ISR(TCBn_INT_vect) of a TCB with INTCTRL.CAPT and INTFLAGS.CAPT set, or ISR(ADC0_RESRDY_vect) with RESRDY,
+  is called as soon as SREG.I is set and no ISR runs, in vector order : TCB0, TCB1, ADC0, TCB2, TCB3.
+  ISRs don't nest, and setting SREG.I by writing SREG only takes effect at the next HostSim_advance(), while
+  sei() / interrupts() serves pending interrupts at once.
+  Not simulated : EVSYS generators other than the TCBs (pins, other peripherals), TCB outputs, TCA itself, and
+  ADC0 conversions other than by event (analogRead() returns the HostSim_setAnalog() value at once).
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+
+#include "avr/io.h"
+
+#ifndef HOST_SIM_TCA_DIV
+  // TCA0 prescaler set by the megaAVR core, TCB_CLKSEL_CLKTCA_gc is then 250KHz at 16MHz
+  #define HOST_SIM_TCA_DIV        64
+#endif
+
+#ifndef HOST_SIM_LOOP_CYCLES
+  #define HOST_SIM_LOOP_CYCLES    1000
+#endif
+
+#ifndef HOST_SIM_POLL_CYCLES
+  #define HOST_SIM_POLL_CYCLES    20
+#endif
+
+#ifndef HOST_SIM_SECONDS
+  // Virtual run time of the sketch, if not given as first argument
+  #define HOST_SIM_SECONDS        10
+#endif
+
+#define HOST_SIM_NUM_TCB          4
+
+// Move virtual time on by cycles, counting the timers and calling the ISRs which become due
+void      HostSim_advance(const uint64_t& cycles);
+
+// CPU cycles since start
+uint64_t  HostSim_cycles();
+
+// CPU cycles added to the virtual time at each ISR call, for ISR entry, prologue and epilogue. 0 by default
+void      HostSim_setISRCycles(const uint32_t& cycles);
+
+// Number of calls of ISR(TCBn_INT_vect)
+uint32_t  HostSim_getISRCount(const uint8_t& timerNo);
+
+// Level of the event input of TCBn, as routed through EVSYS on the chip. Edges as selected by EVCTRL.EDGE
+void      HostSim_setEvent(const uint8_t& timerNo, const uint8_t& level);
+
+// Pulse on the event input of TCBn, i.e. both edges at once, as from EVSYS.STROBE
+void      HostSim_event(const uint8_t& timerNo);
+
+// Level change on pin, calling its attachInterrupt() handler if mode matches
+void      HostSim_setPin(const uint8_t& pin, const uint8_t& level);
+
+// Value returned by analogRead(pin), and converted by ADC0 on channel pin (AINn)
+void      HostSim_setAnalog(const uint8_t& pin, const int& value);
+
+// End the program when the virtual time reaches seconds. Done by the host main() with HOST_SIM_SECONDS
+void      HostSim_setTimeLimit(const double& seconds);
+
+#endif    // HOST_SIM_H
@@ -0,0 +1,32 @@
+/****************************************************************************************************************************
+  avr/interrupt.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host build of the library, see ../HostSim.h. ISR(TCBn_INT_vect) bodies are called by the simulation
+  at the compare matches of TCBn.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_AVR_INTERRUPT_H
+#define HOST_SIM_AVR_INTERRUPT_H
+
+#include "avr/io.h"
+
+void HostSim_sei();
+void HostSim_cli();
+
+#define sei()                 HostSim_sei()
+#define cli()                 HostSim_cli()
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+
+#define ISR(vector, ...)      extern "C" void vector(void); void vector(void)
+
+#endif    // HOST_SIM_AVR_INTERRUPT_H
@@ -0,0 +1,310 @@
+/****************************************************************************************************************************
+  avr/io.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host build of the library, see ../HostSim.h. The ATmega4809 registers used by the library, from iom4809.h.
+  TCB0..TCB3 and ADC0 are simulated by HostSim.cpp. EVSYS and PORTMUX are plain memory, but for EVSYS.STROBE
+  which sends its events to the TCBs.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_AVR_IO_H
+#define HOST_SIM_AVR_IO_H
+
+#include <stdint.h>
+
+#ifndef F_CPU
+  #define F_CPU                   16000000UL
+#endif
+
+typedef volatile uint8_t  register8_t;
+typedef volatile uint16_t register16_t;
+
+// In HostSim.cpp : one CPU cycle, for each read of an interrupt flags register
+void HostSim_readFlags();
+
+// Interrupt flags register : writing 1 to a bit clears it, as on the chip. Only set by the simulation.
+// Reading it takes a CPU cycle, so that a loop polling a flag sees the timers count
+typedef struct host_flags8_t
+{
+  volatile uint8_t value;
+
+  host_flags8_t& operator=(const uint8_t mask)
+  {
+    value &= (uint8_t) ~mask;
+    return *this;
+  }
+
+  operator uint8_t() const
+  {
+    HostSim_readFlags();
+
+    return value;
+  }
+} host_flags8_t;
+
+// In HostSim.cpp : software event on the EVSYS channels of mask, to the TCBs using them
+void HostSim_strobe(const uint8_t mask);
+
+// EVSYS.STROBE : writing 1 to a bit issues a software event on that channel, as on the chip. Reads 0
+typedef struct host_strobe8_t
+{
+  host_strobe8_t& operator=(const uint8_t mask)
+  {
+    HostSim_strobe(mask);
+    return *this;
+  }
+
+  operator uint8_t() const
+  {
+    return 0;
+  }
+} host_strobe8_t;
+
+////////////////////////////////////////////////////////
+
+// CPU
+
+extern volatile uint8_t SREG;
+
+#define CPU_I_bm                        0x80
+
+////////////////////////////////////////////////////////
+
+// TCB, 16-bit Timer Type B
+
+typedef struct TCB_struct
+{
+  register8_t   CTRLA;
+  register8_t   CTRLB;
+  register8_t   reserved_1[2];
+  register8_t   EVCTRL;
+  register8_t   INTCTRL;
+  host_flags8_t INTFLAGS;
+  register8_t   STATUS;
+  register8_t   DBGCTRL;
+  register8_t   TEMP;
+  union
+  {
+    register16_t CNT;
+    struct
+    {
+      register8_t CNTL;
+      register8_t CNTH;
+    };
+  };
+  union
+  {
+    register16_t CCMP;
+    struct
+    {
+      register8_t CCMPL;
+      register8_t CCMPH;
+    };
+  };
+  register8_t   reserved_2[2];
+} TCB_t;
+
+// Contiguous as on the chip, where TCB0-TCB3 are consecutive TCB_t register blocks
+extern TCB_t HostSim_TCB[4];
+
+#define TCB0    (HostSim_TCB[0])
+#define TCB1    (HostSim_TCB[1])
+#define TCB2    (HostSim_TCB[2])
+#define TCB3    (HostSim_TCB[3])
+
+#define TCB_ENABLE_bm                   0x01
+#define TCB_CLKSEL_gm                   0x06
+#define TCB_CLKSEL_CLKDIV1_gc           (0x00<<1)
+#define TCB_CLKSEL_CLKDIV2_gc           (0x01<<1)
+#define TCB_CLKSEL_CLKTCA_gc            (0x02<<1)
+#define TCB_SYNCUPD_bm                  0x10
+#define TCB_RUNSTDBY_bm                 0x40
+
+#define TCB_CNTMODE_gm                  0x07
+#define TCB_CNTMODE_INT_gc              (0x00<<0)
+#define TCB_CNTMODE_TIMEOUT_gc          (0x01<<0)
+#define TCB_CNTMODE_CAPT_gc             (0x02<<0)
+#define TCB_CNTMODE_FRQ_gc              (0x03<<0)
+#define TCB_CNTMODE_PW_gc               (0x04<<0)
+#define TCB_CNTMODE_FRQPW_gc            (0x05<<0)
+#define TCB_CNTMODE_SINGLE_gc           (0x06<<0)
+#define TCB_CNTMODE_PWM8_gc             (0x07<<0)
+#define TCB_CCMPEN_bm                   0x10
+#define TCB_CCMPINIT_bm                 0x20
+#define TCB_ASYNC_bm                    0x40
+
+#define TCB_CAPTEI_bm                   0x01
+#define TCB_EDGE_bm                     0x10
+#define TCB_FILTER_bm                   0x40
+
+#define TCB_CAPT_bm                     0x01
+
+#define TCB_RUN_bm                      0x01
+
+////////////////////////////////////////////////////////
+
+// EVSYS, Event System
+
+typedef struct EVSYS_struct
+{
+  host_strobe8_t STROBE;
+  register8_t reserved_1[15];
+  register8_t CHANNEL0;
+  register8_t CHANNEL1;
+  register8_t CHANNEL2;
+  register8_t CHANNEL3;
+  register8_t CHANNEL4;
+  register8_t CHANNEL5;
+  register8_t CHANNEL6;
+  register8_t CHANNEL7;
+  register8_t reserved_2[8];
+  register8_t USERCCLLUT0A;
+  register8_t USERCCLLUT0B;
+  register8_t USERCCLLUT1A;
+  register8_t USERCCLLUT1B;
+  register8_t USERCCLLUT2A;
+  register8_t USERCCLLUT2B;
+  register8_t USERCCLLUT3A;
+  register8_t USERCCLLUT3B;
+  register8_t USERADC0;
+  register8_t USEREVOUTA;
+  register8_t USEREVOUTB;
+  register8_t USEREVOUTC;
+  register8_t USEREVOUTD;
+  register8_t USEREVOUTE;
+  register8_t USEREVOUTF;
+  register8_t USERUSART0;
+  register8_t USERUSART1;
+  register8_t USERUSART2;
+  register8_t USERUSART3;
+  register8_t USERTCA0;
+  register8_t USERTCB0;
+  register8_t USERTCB1;
+  register8_t USERTCB2;
+  register8_t USERTCB3;
+  register8_t reserved_3[8];
+} EVSYS_t;
+
+extern EVSYS_t EVSYS;
+
+#define EVSYS_GENERATOR_OFF_gc          (0x00<<0)
+#define EVSYS_GENERATOR_PORT0_PIN0_gc   (0x40<<0)
+#define EVSYS_GENERATOR_PORT0_PIN1_gc   (0x41<<0)
+#define EVSYS_GENERATOR_PORT0_PIN2_gc   (0x42<<0)
+#define EVSYS_GENERATOR_PORT0_PIN3_gc   (0x43<<0)
+#define EVSYS_GENERATOR_PORT1_PIN0_gc   (0x48<<0)
+#define EVSYS_GENERATOR_PORT1_PIN1_gc   (0x49<<0)
+#define EVSYS_GENERATOR_TCB0_CAPT_gc    (0xA0<<0)
+#define EVSYS_GENERATOR_TCB1_CAPT_gc    (0xA2<<0)
+#define EVSYS_GENERATOR_TCB2_CAPT_gc    (0xA4<<0)
+#define EVSYS_GENERATOR_TCB3_CAPT_gc    (0xA6<<0)
+
+////////////////////////////////////////////////////////
+
+// PORTMUX
+
+typedef struct PORTMUX_struct
+{
+  register8_t EVSYSROUTEA;
+  register8_t CCLROUTEA;
+  register8_t USARTROUTEA;
+  register8_t TWISPIROUTEA;
+  register8_t TCAROUTEA;
+  register8_t TCBROUTEA;
+  register8_t reserved_1[10];
+} PORTMUX_t;
+
+extern PORTMUX_t PORTMUX;
+
+#define PORTMUX_TCB0_bm                 0x01
+#define PORTMUX_TCB1_bm                 0x02
+#define PORTMUX_TCB2_bm                 0x04
+#define PORTMUX_TCB3_bm                 0x08
+
+////////////////////////////////////////////////////////
+
+// ADC. Conversions started by EVSYS events, see HostSim.cpp
+
+// In HostSim.cpp : ADC0.RES, clearing ADC0.INTFLAGS.RESRDY as on the chip
+uint16_t HostSim_readADCResult();
+
+// ADC0.RES : reading it clears RESRDY
+typedef struct host_result16_t
+{
+  volatile uint16_t value;
+
+  host_result16_t& operator=(const uint16_t result)
+  {
+    value = result;
+    return *this;
+  }
+
+  operator uint16_t() const
+  {
+    return HostSim_readADCResult();
+  }
+} host_result16_t;
+
+typedef struct ADC_struct
+{
+  register8_t   CTRLA;
+  register8_t   CTRLB;
+  register8_t   CTRLC;
+  register8_t   CTRLD;
+  register8_t   CTRLE;
+  register8_t   SAMPCTRL;
+  register8_t   MUXPOS;
+  register8_t   reserved_1;
+  register8_t   COMMAND;
+  register8_t   EVCTRL;
+  register8_t   INTCTRL;
+  host_flags8_t INTFLAGS;
+  register8_t   DBGCTRL;
+  register8_t   TEMP;
+  register8_t   reserved_2[2];
+  host_result16_t RES;
+  register16_t  WINLT;
+  register16_t  WINHT;
+  register8_t   CALIB;
+  register8_t   reserved_3;
+} ADC_t;
+
+extern ADC_t ADC0;
+
+#define ADC_ENABLE_bm                   0x01
+#define ADC_FREERUN_bm                  0x02
+#define ADC_RESSEL_bm                   0x04
+#define ADC_RESSEL_10BIT_gc             (0x00<<2)
+#define ADC_RESSEL_8BIT_gc              (0x01<<2)
+#define ADC_PRESC_gm                    0x07
+#define ADC_PRESC_DIV2_gc               (0x00<<0)
+#define ADC_PRESC_DIV4_gc               (0x01<<0)
+#define ADC_PRESC_DIV8_gc               (0x02<<0)
+#define ADC_PRESC_DIV16_gc              (0x03<<0)
+#define ADC_PRESC_DIV32_gc              (0x04<<0)
+#define ADC_PRESC_DIV64_gc              (0x05<<0)
+#define ADC_PRESC_DIV128_gc             (0x06<<0)
+#define ADC_PRESC_DIV256_gc             (0x07<<0)
+#define ADC_SAMPDLY_gm                  0x0F
+#define ADC_ASDV_bm                     0x10
+#define ADC_INITDLY_gm                  0xE0
+#define ADC_SAMPLEN_gm                  0x1F
+#define ADC_STCONV_bm                   0x01
+#define ADC_STARTEI_bm                  0x01
+#define ADC_RESRDY_bm                   0x01
+#define ADC_MUXPOS_AIN0_gc              (0x00<<0)
+#define ADC_MUXPOS_AIN1_gc              (0x01<<0)
+#define ADC_MUXPOS_AIN2_gc              (0x02<<0)
+#define ADC_MUXPOS_AIN3_gc              (0x03<<0)
+#define ADC_MUXPOS_AIN4_gc              (0x04<<0)
+#define ADC_MUXPOS_AIN5_gc              (0x05<<0)
+#define ADC_MUXPOS_AIN6_gc              (0x06<<0)
+#define ADC_MUXPOS_AIN7_gc              (0x07<<0)
+
+#endif    // HOST_SIM_AVR_IO_H
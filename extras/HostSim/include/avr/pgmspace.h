@@ -0,0 +1,33 @@
+/****************************************************************************************************************************
+  avr/pgmspace.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host build of the library, see ../HostSim.h. Flash data is ordinary memory on the host.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_AVR_PGMSPACE_H
+#define HOST_SIM_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                 const char*
+#define PSTR(s)               (s)
+
+#define pgm_read_byte(addr)   (*(const uint8_t*)  (addr))
+#define pgm_read_word(addr)   (*(const uint16_t*) (addr))
+#define pgm_read_dword(addr)  (*(const uint32_t*) (addr))
+#define pgm_read_ptr(addr)    (*(void* const*)    (addr))
+
+#define strlen_P              strlen
+#define strcmp_P              strcmp
+#define memcpy_P              memcpy
+
+#endif    // HOST_SIM_AVR_PGMSPACE_H
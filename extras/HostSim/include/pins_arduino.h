@@ -0,0 +1,43 @@
+/****************************************************************************************************************************
+  pins_arduino.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host build of the library, see HostSim.h. Pin numbers of the Nano Every.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef HOST_SIM_PINS_ARDUINO_H
+#define HOST_SIM_PINS_ARDUINO_H
+
+#define NUM_DIGITAL_PINS      22
+#define NUM_ANALOG_INPUTS     8
+
+#define LED_BUILTIN           13
+
+#define PIN_A0                14
+#define PIN_A1                15
+#define PIN_A2                16
+#define PIN_A3                17
+#define PIN_A4                18
+#define PIN_A5                19
+#define PIN_A6                20
+#define PIN_A7                21
+
+#define A0                    PIN_A0
+#define A1                    PIN_A1
+#define A2                    PIN_A2
+#define A3                    PIN_A3
+#define A4                    PIN_A4
+#define A5                    PIN_A5
+#define A6                    PIN_A6
+#define A7                    PIN_A7
+
+#define SDA                   22
+#define SCL                   23
+
+#endif    // HOST_SIM_PINS_ARDUINO_H
@@ -0,0 +1,563 @@
+#!/usr/bin/env python3
+"""
+  isr_wcet.py
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Static worst-case cycle count of the TCB interrupt vectors and of ISR_Timer::run(), from the disassembly of a
+  built sketch. Cycles are those of the AVRxt core of the megaAVR 0-series, see the AVR Instruction Set Manual.
+
+    avr-objdump -d -C sketch.ino.elf > sketch.lst
+    python3 isr_wcet.py sketch.lst
+
+  or directly python3 isr_wcet.py sketch.ino.elf, with avr-objdump (or $OBJDUMP) in the PATH. In the Arduino IDE,
+  "Sketch > Export compiled Binary" leaves the .elf in the sketch build directory.
+
+  The bound of a vector is the interrupt response (5 cycles), the jump from the vector table (3 cycles), then the
+  longest path through the handler, its prologue, epilogue and reti included, and through the functions it calls.
+  Not included : the instruction being completed when the interrupt comes, and the time the interrupt waits
+  while interrupts are disabled, e.g. by another ISR.
+
+  - Indirect calls (icall), i.e. the timer callbacks, are externals costing --icall-cycles each (0 by default).
+    The table shows how many are on the worst path, to add the worst callback time.
+  - Named functions can be made externals too with --extern 'regex=cycles', e.g. a callback called directly.
+  - Each loop needs a bound, the max number of times its header runs per entry. Known ones are built in : the
+    timer loops of ISR_TimerT<N>::runTimers(), the full scan of run(), bounded by the N of its demangled name, and
+    the bit loops of libgcc.
+    Others are given by --loop 'regex=N' for all loops of the matching functions, or --loop 0xADDR=N for the
+    loop whose header is at ADDR, e.g. --loop '__vector_=12' for the histogram loop of TimerInterrupt_addStats()
+    with TIMER_INTERRUPT_USE_STATS and the default TIMER_STATS_HISTOGRAM_BINS. An unbounded loop is counted
+    with --default-loop-bound and reported.
+  - Indirect jumps (ijmp, e.g. switch tables) and recursion can't be bounded, and are reported.
+
+  Output is a table, or JSON with --json, to compare library versions and ISR policies.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+# ATmega4809 / 3209 / 1609 / 809 interrupt vectors of the TCBs
+TCB_VECTORS = {12: 'TCB0', 13: 'TCB1', 25: 'TCB2', 36: 'TCB3'}
+
+# Interrupt response, then jmp of the vector table. reti is counted with the handler
+ISR_RESPONSE_CYCLES = 5
+ISR_VECTOR_JMP_CYCLES = 3
+
+# Functions reported besides the vectors
+REPORTED_FUNCTIONS = r'ISR_TimerT.*run'
+
+# Loop bounds from a template argument : (function regex, group of the bound). The timers of ISR_TimerT<N>,
+# scanned and dispatched, demangled as ISR_TimerT<(unsigned char)16>::runTimers(unsigned long)
+TEMPLATE_LOOP_BOUNDS = [
+    (r'ISR_TimerT<(?:\(unsigned char\))?(\d+)>::run(?:Timers)?\(', 1),
+]
+
+# Default loop bounds : (function regex, max header runs)
+BUILTIN_LOOP_BOUNDS = [
+    (r'__udivmodqi4',           9),
+    (r'__udivmodhi4',           17),
+    (r'__udivmodsi4',           33),
+    (r'__udivmod64',            65),
+    (r'__(ctz|ffs)hi2',         16),
+    (r'__(ctz|ffs)si2',         32),
+]
+
+# AVRxt cycles. Conditional branches 1 / 2 if taken, skips 1 / 2 / 3 are handled apart
+CYCLES = {}
+
+for m in ('add adc sub subi sbc sbci and andi or ori eor com neg sbr cbr inc dec tst clr ser mov movw ldi cp cpc '
+          'cpi swap lsl lsr rol ror asr bst bld sec clc sen cln sez clz sei cli ses cls sev clv set clt seh clh '
+          'bset bclr nop in out sbi cbi sleep wdr break st std push').split():
+    CYCLES[m] = 1
+
+for m in 'adiw sbiw mul muls mulsu fmul fmuls fmulsu ld ldd pop sts rjmp ijmp eijmp rcall icall'.split():
+    CYCLES[m] = 2
+
+for m in 'lds lpm elpm jmp call eicall'.split():
+    CYCLES[m] = 3
+
+for m in 'ret reti'.split():
+    CYCLES[m] = 4
+
+BRANCHES    = set(('breq brne brcs brcc brsh brlo brmi brpl brge brlt brhs brhc brts brtc brvs brvc brie brid '
+                   'brbs brbc').split())
+SKIPS       = set('cpse sbrc sbrs sbic sbis'.split())
+JUMPS       = set('rjmp jmp'.split())
+CALLS       = set('rcall call'.split())
+ICALLS      = set('icall eicall'.split())
+IJUMPS      = set('ijmp eijmp'.split())
+RETURNS     = set('ret reti'.split())
+
+LABEL_RE    = re.compile(r'^([0-9a-f]+) <(.+)>:\s*$')
+INSN_RE     = re.compile(r'^\s*([0-9a-f]+):\t((?:[0-9a-f]{2} )+)\s*\t?([a-z]+)\s*([^;]*?)\s*(?:;\s*(.*))?$')
+TARGET_RE   = re.compile(r'0x([0-9a-f]+)')
+
+
+class Cost:
+    """Cycles, and indirect calls on the path"""
+
+    __slots__ = ('cycles', 'icalls')
+
+    def __init__(self, cycles=0, icalls=0):
+        self.cycles = cycles
+        self.icalls = icalls
+
+    def __add__(self, other):
+        return Cost(self.cycles + other.cycles, self.icalls + other.icalls)
+
+    def __mul__(self, n):
+        return Cost(self.cycles * n, self.icalls * n)
+
+    def key(self):
+        return (self.cycles, self.icalls)
+
+
+class Insn:
+    __slots__ = ('addr', 'size', 'mnemonic', 'operands', 'target')
+
+    def __init__(self, addr, size, mnemonic, operands, target):
+        self.addr       = addr
+        self.size       = size
+        self.mnemonic   = mnemonic
+        self.operands   = operands
+        self.target     = target
+
+
+def parse_listing(lines):
+    """Return {name: [Insn]} and {address: name} of the functions"""
+    functions = {}
+    starts    = {}
+    current   = None
+
+    for line in lines:
+        m = LABEL_RE.match(line)
+
+        if m:
+            current = m.group(2)
+            starts[int(m.group(1), 16)] = current
+            functions.setdefault(current, [])
+            continue
+
+        m = INSN_RE.match(line)
+
+        if not m or current is None:
+            continue
+
+        addr        = int(m.group(1), 16)
+        size        = len(m.group(2).split())           # in bytes, 2 or 4
+        mnemonic    = m.group(3)
+        operands    = m.group(4)
+        comment     = m.group(5) or ''
+        target      = None
+
+        if mnemonic in BRANCHES or mnemonic in JUMPS or mnemonic in CALLS:
+            t = TARGET_RE.search(comment) or TARGET_RE.search(operands)
+
+            if t:
+                target = int(t.group(1), 16)
+            else:
+                rel = re.search(r'\.([+-]\d+)', operands)
+
+                if rel:
+                    target = addr + 2 + int(rel.group(1))
+
+            # Data space addresses of the comment are 0x800000 and up, code ones are not
+            if target is not None:
+                target &= 0x7FFFFF
+
+        functions[current].append(Insn(addr, size, mnemonic, operands, target))
+
+    return functions, starts
+
+
+class Analyzer:
+
+    def __init__(self, functions, starts, args):
+        self.functions      = functions
+        self.starts         = starts
+        self.icall_cycles   = args.icall_cycles
+        self.default_bound  = args.default_loop_bound
+        self.addr_bounds    = {}
+        self.name_bounds    = []
+        self.template_bounds = [(re.compile(r), g) for r, g in TEMPLATE_LOOP_BOUNDS]
+        self.externs        = []
+        self.memo           = {}
+        self.active         = set()
+
+        for spec in args.loop or []:
+            key, _, value = spec.rpartition('=')
+
+            if key.lower().startswith('0x'):
+                self.addr_bounds[int(key, 16)] = int(value)
+            else:
+                self.name_bounds.append((re.compile(key), int(value)))
+
+        self.name_bounds += [(re.compile(r), n) for r, n in BUILTIN_LOOP_BOUNDS]
+
+        for spec in args.extern or []:
+            key, _, value = spec.rpartition('=')
+            self.externs.append((re.compile(key), int(value)))
+
+    def loop_bound(self, name, header, notes):
+        if header in self.addr_bounds:
+            return self.addr_bounds[header]
+
+        for regex, n in self.name_bounds:
+            if regex.search(name):
+                return n
+
+        for regex, group in self.template_bounds:
+            m = regex.search(name)
+
+            if m:
+                return int(m.group(group))
+
+        notes.add('unbounded loop at 0x%x in %s' % (header, name))
+
+        return self.default_bound
+
+    def wcet(self, name):
+        """(Cost, notes) of the longest path through function name, its ret included"""
+        if name in self.memo:
+            return self.memo[name]
+
+        for regex, cycles in self.externs:
+            if regex.search(name):
+                self.memo[name] = (Cost(cycles), set())
+                return self.memo[name]
+
+        if name in self.active:
+            return Cost(), set(['recursion through %s' % name])
+
+        self.active.add(name)
+
+        result = self.analyze(name)
+
+        self.active.discard(name)
+
+        self.memo[name] = result
+
+        return result
+
+    def callee(self, target, notes):
+        if target not in self.starts:
+            notes.add('call to unknown 0x%x' % target)
+            return Cost()
+
+        cost, callee_notes = self.wcet(self.starts[target])
+        notes.update(callee_notes)
+
+        return cost
+
+    def analyze(self, name):
+        insns   = self.functions.get(name, [])
+        notes   = set()
+
+        if not insns:
+            return Cost(), set(['no code for %s' % name])
+
+        at      = {i.addr: i for i in insns}
+        cost    = {}
+        succ    = {}
+
+        # Graph of instructions : node cost, and edges (successor, extra cost)
+        for k, i in enumerate(insns):
+            nxt     = insns[k + 1].addr if k + 1 < len(insns) else None
+            m       = i.mnemonic
+            c       = Cost(CYCLES.get(m, 1))
+            edges   = []
+
+            if m not in CYCLES and m not in BRANCHES and m not in SKIPS:
+                notes.add('unknown instruction %s at 0x%x' % (m, i.addr))
+
+            if m in BRANCHES:
+                edges = [(nxt, Cost()), (i.target, Cost(1))]
+
+            elif m in SKIPS:
+                skipped = at.get(nxt)
+                after   = (nxt + skipped.size) if skipped else None
+                edges   = [(nxt, Cost()), (after, Cost(1 if skipped and skipped.size == 2 else 2))]
+
+            elif m in JUMPS:
+                if i.target in at:
+                    edges = [(i.target, Cost())]
+                else:
+                    # Tail call
+                    c = c + self.callee(i.target, notes)
+
+            elif m in CALLS:
+                c       = c + self.callee(i.target, notes)
+                edges   = [(nxt, Cost())]
+
+            elif m in ICALLS:
+                c       = c + Cost(self.icall_cycles, 1)
+                edges   = [(nxt, Cost())]
+
+            elif m in IJUMPS:
+                notes.add('indirect jump at 0x%x in %s' % (i.addr, name))
+
+            elif m not in RETURNS:
+                edges = [(nxt, Cost())]
+
+            cost[i.addr] = c
+            succ[i.addr] = [(v, e) for v, e in edges if v in at]
+
+        entry       = insns[0].addr
+        header_of   = {a: a for a in cost}
+
+        # Collapse the loops, innermost first, until the graph is acyclic
+        while True:
+            loop = self.innermost_loop(entry, succ)
+
+            if loop is None:
+                break
+
+            header, body = loop
+            entry = self.collapse(name, entry, header, body, cost, succ, header_of, notes)
+
+            if entry is None:
+                return Cost(), notes
+
+        order = self.topological(entry, succ)
+
+        if order is None:
+            notes.add('irreducible loop in %s' % name)
+            return Cost(), notes
+
+        dist = {entry: cost[entry]}
+        best = Cost()
+
+        for u in order:
+            if not succ[u] and dist[u].key() > best.key():
+                best = dist[u]
+
+            for v, e in succ[u]:
+                d = dist[u] + e + cost[v]
+
+                if v not in dist or d.key() > dist[v].key():
+                    dist[v] = d
+
+        return best, notes
+
+    @staticmethod
+    def innermost_loop(entry, succ):
+        """(header, body) of the smallest natural loop, or None"""
+        back    = []
+        state   = {}
+        stack   = [(entry, iter(succ[entry]))]
+        state[entry] = 1
+
+        while stack:
+            u, it = stack[-1]
+            advanced = False
+
+            for v, _ in it:
+                if state.get(v) == 1:
+                    back.append((u, v))
+                elif v not in state:
+                    state[v] = 1
+                    stack.append((v, iter(succ[v])))
+                    advanced = True
+                    break
+
+            if not advanced:
+                state[u] = 2
+                stack.pop()
+
+        if not back:
+            return None
+
+        pred = {}
+
+        for u, edges in succ.items():
+            for v, _ in edges:
+                pred.setdefault(v, []).append(u)
+
+        loops = {}
+
+        for latch, header in back:
+            body = loops.setdefault(header, set([header]))
+            work = [latch]
+
+            while work:
+                n = work.pop()
+
+                if n not in body:
+                    body.add(n)
+                    work.extend(pred.get(n, []))
+
+        header = min(loops, key=lambda h: len(loops[h]))
+
+        return header, loops[header]
+
+    def collapse(self, name, entry, header, body, cost, succ, header_of, notes):
+        """Replace the loop by a node, whose edges to the exits cost all iterations. Return the new entry"""
+        inner = {u: [(v, e) for v, e in succ[u] if v in body and v != header] for u in body}
+        order = self.topological(header, inner)
+
+        if order is None:
+            notes.add('irreducible loop at 0x%x in %s' % (header_of[header], name))
+            return None
+
+        dist = {header: cost[header]}
+
+        for u in order:
+            for v, e in inner[u]:
+                d = dist[u] + e + cost[v]
+
+                if v not in dist or d.key() > dist[v].key():
+                    dist[v] = d
+
+        iteration = Cost()
+        exits     = {}
+
+        for u in body:
+            if u not in dist:
+                continue
+
+            for v, e in succ[u]:
+                if v == header:
+                    if (dist[u] + e).key() > iteration.key():
+                        iteration = dist[u] + e
+                elif v not in body:
+                    d = dist[u] + e
+
+                    if v not in exits or d.key() > exits[v].key():
+                        exits[v] = d
+
+        bound = self.loop_bound(name, header_of[header], notes)
+
+        if not exits:
+            notes.add('endless loop at 0x%x in %s' % (header_of[header], name))
+
+        node = ('loop', header_of[header], len(body))
+
+        cost[node]      = Cost()
+        succ[node]      = [(v, iteration * max(bound - 1, 0) + d) for v, d in exits.items()]
+        header_of[node] = header_of[header]
+
+        for u in list(succ):
+            if u in body or u == node:
+                continue
+
+            edges = []
+
+            for v, e in succ[u]:
+                if v == header:
+                    edges.append((node, e))
+                elif v in body:
+                    notes.add('loop at 0x%x in %s entered at 0x%x' % (header_of[header], name, header_of[v]))
+                else:
+                    edges.append((v, e))
+
+            succ[u] = edges
+
+        for u in body:
+            del succ[u]
+            del cost[u]
+
+        return node if entry in body else entry
+
+    @staticmethod
+    def topological(entry, succ):
+        """Nodes reachable from entry in topological order, None if there is a cycle"""
+        order   = []
+        state   = {entry: 1}
+        stack   = [(entry, iter(succ[entry]))]
+
+        while stack:
+            u, it = stack[-1]
+            advanced = False
+
+            for v, _ in it:
+                s = state.get(v)
+
+                if s == 1:
+                    return None
+
+                if s is None:
+                    state[v] = 1
+                    stack.append((v, iter(succ[v])))
+                    advanced = True
+                    break
+
+            if not advanced:
+                state[u] = 2
+                order.append(u)
+                stack.pop()
+
+        order.reverse()
+
+        return order
+
+
+def read_listing(path):
+    with open(path, 'rb') as f:
+        elf = f.read(4) == b'\x7fELF'
+
+    if not elf:
+        with open(path) as f:
+            return f.readlines()
+
+    objdump = os.environ.get('OBJDUMP', 'avr-objdump')
+
+    return subprocess.run([objdump, '-d', '-C', path], check=True, stdout=subprocess.PIPE,
+                          universal_newlines=True).stdout.splitlines()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Worst-case cycles of the TCB ISRs and ISR_Timer::run()')
+    parser.add_argument('input', help='avr-objdump -d -C listing, or the .elf')
+    parser.add_argument('--f-cpu', type=float, default=16e6, help='CPU frequency for the us column, default 16e6')
+    parser.add_argument('--icall-cycles', type=int, default=0, help='cycles of each indirect call (callback)')
+    parser.add_argument('--extern', action='append', metavar='REGEX=CYCLES',
+                        help='functions matching REGEX cost CYCLES, their ret included')
+    parser.add_argument('--loop', action='append', metavar='REGEX=N|0xADDR=N', help='loop bound')
+    parser.add_argument('--default-loop-bound', type=int, default=16, help='bound of unannotated loops')
+    parser.add_argument('--function', action='append', metavar='REGEX',
+                        help='more functions to report, default: ' + REPORTED_FUNCTIONS)
+    parser.add_argument('--json', action='store_true', help='JSON output')
+    args = parser.parse_args()
+
+    functions, starts = parse_listing(read_listing(args.input))
+    analyzer = Analyzer(functions, starts, args)
+
+    rows = []
+
+    for vector, timer in sorted(TCB_VECTORS.items()):
+        name = '__vector_%u' % vector
+
+        if name in functions:
+            cost, notes = analyzer.wcet(name)
+            rows.append((timer, name, cost + Cost(ISR_RESPONSE_CYCLES + ISR_VECTOR_JMP_CYCLES), notes))
+
+    reported = [re.compile(r) for r in [REPORTED_FUNCTIONS] + (args.function or [])]
+
+    for name in sorted(functions):
+        if not name.startswith('__vector_') and any(r.search(name) for r in reported):
+            cost, notes = analyzer.wcet(name)
+            rows.append(('', name, cost, notes))
+
+    if args.json:
+        json.dump([{'vector': timer, 'function': name, 'cycles': cost.cycles, 'us': cost.cycles * 1e6 / args.f_cpu,
+                    'icalls': cost.icalls, 'notes': sorted(notes)} for timer, name, cost, notes in rows],
+                  sys.stdout, indent=2)
+        sys.stdout.write('\n')
+    else:
+        print('%-6s %-44s %8s %10s %7s  %s' % ('Vector', 'Function', 'Cycles', 'us', 'icalls', 'Notes'))
+
+        for timer, name, cost, notes in rows:
+            print('%-6s %-44s %8u %10.2f %7u  %s' % (timer, name[:44], cost.cycles, cost.cycles * 1e6 / args.f_cpu,
+                                                    cost.icalls, '; '.join(sorted(notes))))
+
+    return 0 if rows else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
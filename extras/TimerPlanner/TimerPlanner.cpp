@@ -0,0 +1,258 @@
+/****************************************************************************************************************************
+  TimerPlanner.cpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host planner of the TCB timers, with the clock selection and period math of setFrequency(), from
+  megaAVR_TimerClock.h. Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 -I../../src TimerPlanner.cpp -o TimerPlanner
+    ./TimerPlanner [options] period...
+
+  Periods are a number with unit ns, us, ms, s or min, or a frequency with unit Hz, kHz or MHz, e.g.
+    ./TimerPlanner -f 20M 50us 1ms 100Hz 10min
+
+  Options :
+    -f F_CPU    CPU frequency in Hz, or with suffix M, default 16M. 20M for MegaCoreX at 20MHz
+    -e PPM      max error accepted when selecting the clock, default 1000 as TIMER_INTERRUPT_MAX_ERROR_PPM
+    -c CYCLES   CPU cycles per interrupt, entry to reti with the callback, default 100. See extras/ISR_WCET
+    -t LIST     TCBs free for the timers, default 0,1,2,3. The core may use one, e.g. for millis()
+
+  Rates are assigned rate-monotonic : the shortest period to the free TCB of highest interrupt priority,
+  i.e. of lowest vector number (TCB0, TCB1, TCB2 then TCB3), as it is served first when interrupts are pending
+  together. Rates beyond the free TCBs are left for an ISR_Timer. For each timer : TCB clock, ticks, CCMP,
+  segments (interrupts per period, a period longer than 65536 ticks being split), error of the achieved
+  frequency, interrupts per second and CPU load of its ISR.
+*****************************************************************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <stdint.h>
+
+#include "megaAVR_TimerClock.h"
+
+#define DEFAULT_F_CPU         16000000UL
+#define DEFAULT_ERROR_PPM     1000UL
+#define DEFAULT_ISR_CYCLES    100UL
+
+// TCB0-TCB3 and their interrupt vectors on ATmega4809, in order of priority
+static const uint8_t tcbVectors[] = { 12, 13, 25, 36 };
+
+static const char* clockNames[NUM_TCB_CLOCKS] = { "CLKDIV1", "CLKDIV2", "CLKTCA" };
+
+typedef struct
+{
+  const char* spec;
+  double      frequency;    // Hz, as requested
+  int8_t      clock;        // index, -1 if out of range
+  uint32_t    ticks;
+  uint32_t    segments;
+  uint16_t    ccmp;         // of the first segment
+  double      errorPPM;     // of the achieved frequency
+  double      interruptsPerSecond;
+} plan_t;
+
+static void usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [-f F_CPU] [-e PPM] [-c CYCLES] [-t TCB,...] period...\n", name);
+  fprintf(stderr, "  period : number with unit ns, us, ms, s, min, Hz, kHz or MHz, e.g. 50us 100Hz 10min\n");
+  exit(1);
+}
+
+// Frequency (in Hz) of spec, 0 if invalid
+static double parseRate(const char* spec)
+{
+  char*   unit;
+  double  value = strtod(spec, &unit);
+
+  if (value <= 0)
+    return 0;
+
+  static const struct
+  {
+    const char* unit;
+    double      seconds;      // of a period, or < 0 for 1 / frequency factor
+  } units[] =
+  {
+    { "ns", 1e-9 }, { "us", 1e-6 }, { "ms", 1e-3 }, { "s", 1 }, { "min", 60 },
+    { "Hz", -1 }, { "kHz", -1e3 }, { "MHz", -1e6 }
+  };
+
+  for (size_t i = 0; i < sizeof(units) / sizeof(units[0]); i++)
+  {
+    if (strcmp(unit, units[i].unit) == 0)
+      return (units[i].seconds < 0) ? value * -units[i].seconds : 1 / (value * units[i].seconds);
+  }
+
+  return 0;
+}
+
+// As TimerInterrupt::setFrequency(), with float frequency as on AVR
+static void planRate(plan_t& plan, const uint32_t fCpu, const uint32_t maxErrorPPM)
+{
+  uint32_t ticksPerClock[NUM_TCB_CLOCKS];
+
+  for (uint8_t i = 0; i < NUM_TCB_CLOCKS; i++)
+    ticksPerClock[i] = TimerInterrupt_frequencyToTicks(fCpu / TimerInterrupt_dividerOf(i), (float) plan.frequency);
+
+  plan.clock = TimerInterrupt_selectClockIndex(ticksPerClock, TIMER_CLOCK_AUTO, maxErrorPPM);
+
+  if (plan.clock < 0)
+    return;
+
+  uint32_t clockFrequency = fCpu / TimerInterrupt_dividerOf(plan.clock);
+  uint16_t segmentCCMP;
+
+  plan.ticks        = ticksPerClock[plan.clock];
+  plan.segments     = TimerInterrupt_segmentsOf(plan.ticks);
+  segmentCCMP       = TimerInterrupt_segmentCCMPOf(plan.ticks, plan.segments);
+  plan.ccmp         = (plan.ticks % plan.segments != 0) ? segmentCCMP + 1 : segmentCCMP;
+  plan.errorPPM     = ( ( (double) clockFrequency / plan.ticks ) - plan.frequency ) * 1e6 / plan.frequency;
+  plan.interruptsPerSecond = ( (double) clockFrequency / plan.ticks ) * plan.segments;
+}
+
+static void printPeriod(const double frequency)
+{
+  double period = 1 / frequency;
+
+  if (period < 1e-3)
+    printf("%9.3f us ", period * 1e6);
+  else if (period < 1)
+    printf("%9.3f ms ", period * 1e3);
+  else
+    printf("%9.3f s  ", period);
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t fCpu         = DEFAULT_F_CPU;
+  uint32_t maxErrorPPM  = DEFAULT_ERROR_PPM;
+  uint32_t isrCycles    = DEFAULT_ISR_CYCLES;
+
+  std::vector<uint8_t>  timers;
+  std::vector<plan_t>   plans;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ( (argv[i][0] == '-') && (argv[i][1] != 0) && (argv[i][2] == 0) && (i + 1 < argc) )
+    {
+      const char* value = argv[++i];
+      char*       end;
+
+      switch (argv[i - 1][1])
+      {
+        case 'f':
+          fCpu = strtod(value, &end) * ( (*end == 'M') ? 1e6 : 1 );
+          break;
+
+        case 'e':
+          maxErrorPPM = std::max(1L, strtol(value, NULL, 10));
+          break;
+
+        case 'c':
+          isrCycles = strtoul(value, NULL, 10);
+          break;
+
+        case 't':
+          for (const char* p = value; *p; p++)
+          {
+            if ( (*p >= '0') && (*p <= '3') )
+              timers.push_back(*p - '0');
+          }
+
+          break;
+
+        default:
+          usage(argv[0]);
+      }
+
+      continue;
+    }
+
+    plan_t plan = { argv[i], parseRate(argv[i]), -1, 0, 0, 0, 0, 0 };
+
+    if (plan.frequency == 0)
+    {
+      fprintf(stderr, "%s: invalid period %s\n", argv[0], argv[i]);
+      usage(argv[0]);
+    }
+
+    plans.push_back(plan);
+  }
+
+  if (plans.empty() || (fCpu == 0))
+    usage(argv[0]);
+
+  if (timers.empty())
+  {
+    for (uint8_t t = 0; t < sizeof(tcbVectors); t++)
+      timers.push_back(t);
+  }
+
+  std::sort(timers.begin(), timers.end());
+  timers.erase(std::unique(timers.begin(), timers.end()), timers.end());
+
+  // Rate-monotonic : shortest period first
+  std::stable_sort(plans.begin(), plans.end(), [](const plan_t& a, const plan_t& b)
+  {
+    return a.frequency > b.frequency;
+  });
+
+  printf("F_CPU = %lu Hz, max error = %lu ppm, %lu cycles per interrupt\n\n", (unsigned long) fCpu,
+         (unsigned long) maxErrorPPM, (unsigned long) isrCycles);
+  printf("Timer  Request      Period       Clock           Ticks   CCMP Segments   Error ppm  Interrupts/s  Load %%\n");
+
+  double totalLoad = 0;
+  size_t assigned  = 0;
+
+  for (size_t i = 0; i < plans.size(); i++)
+  {
+    plan_t& plan = plans[i];
+
+    planRate(plan, fCpu, maxErrorPPM);
+
+    if ( (plan.clock >= 0) && (assigned < timers.size()) )
+      printf("TCB%u   ", timers[assigned]);
+    else
+      printf("-      ");
+
+    printf("%-12s ", plan.spec);
+    printPeriod(plan.frequency);
+
+    if (plan.clock < 0)
+    {
+      printf("out of range, from 1 tick at %lu Hz to %.0f s\n", (unsigned long) fCpu,
+             (double) MAX_TICKS_PER_PERIOD * TimerInterrupt_dividerOf(NUM_TCB_CLOCKS - 1) / fCpu);
+      continue;
+    }
+
+    double load = plan.interruptsPerSecond * isrCycles * 100 / fCpu;
+
+    printf("%-7s %7.4gMHz %10lu %6u %8lu %11.1f %13.3f %7.3f", clockNames[plan.clock],
+           (double) fCpu / TimerInterrupt_dividerOf(plan.clock) / 1e6, (unsigned long) plan.ticks, plan.ccmp,
+           (unsigned long) plan.segments, plan.errorPPM, plan.interruptsPerSecond, load);
+
+    if ( (plan.errorPPM > maxErrorPPM) || (plan.errorPPM < -(double) maxErrorPPM) )
+      printf("  over max error");
+
+    if (assigned < timers.size())
+    {
+      totalLoad += load;
+      assigned++;
+    }
+    else
+      printf("  no TCB left, use an ISR_Timer");
+
+    printf("\n");
+  }
+
+  printf("\nISR load of the TCBs : %.3f %%%s\n", totalLoad, (totalLoad >= 100) ? ", over the CPU" : "");
+
+  return 0;
+}
@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""
+  tisr_trace.py
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Decoder of the binary trace dumped by TISR_traceDump() (see src/TimerInterrupt_Generic_Debug.h).
+  Writes a Chrome trace JSON file, to be opened with chrome://tracing or https://ui.perfetto.dev, and prints
+  per-timer period, jitter and CPU load.
+
+  Build the sketch with, before #include "megaAVR_TimerInterrupt.h"
+
+    #define TISR_TRACE_LEVEL      4       // ISR, callback, CCMP reload and ISR_Timer::run() trace points
+
+  and call TISR_traceDump() from loop(). Capture the Serial port raw, e.g.
+
+    stty -F /dev/ttyACM0 115200 raw -echo
+    cat /dev/ttyACM0 > capture.bin
+
+  then
+
+    python3 tisr_trace.py capture.bin -o trace.json
+
+  Frames are found by their sync bytes and checksum, so text printed by the sketch in between is skipped.
+"""
+
+import argparse
+import json
+import math
+import struct
+import sys
+
+SYNC                = b'\xA5\x5A'
+RECORD              = struct.Struct('<BBHII')     # event, timer, arg1, time, arg0
+FRAME_SIZE          = len(SYNC) + RECORD.size + 1
+
+TIMER_DONE          = 1
+ISR_ENTER           = 3
+ISR_EXIT            = 4
+CALLBACK_START      = 5
+CALLBACK_END        = 6
+CCMP_RELOAD         = 7
+RUN_START           = 8
+RUN_END             = 9
+CLOCK_INFO          = 0x70
+DROPPED             = 0x71
+USER                = 0x80
+
+PID_TCB             = 1
+PID_ISR_TIMER       = 2
+PID_USER            = 3
+
+# Span kinds : begin event => (end event, pid, name)
+SPANS = {
+    ISR_ENTER       : (ISR_EXIT,      PID_TCB,        'ISR'),
+    CALLBACK_START  : (CALLBACK_END,  PID_TCB,        'callback'),
+    RUN_START       : (RUN_END,       PID_ISR_TIMER,  'run'),
+}
+
+ENDS = {end: begin for begin, (end, _, _) in SPANS.items()}
+
+
+def read_frames(data):
+    """Yield (event, timer, arg1, time, arg0) of the valid frames, and the number of bytes skipped"""
+    pos     = 0
+    skipped = 0
+
+    while True:
+        found = data.find(SYNC, pos)
+
+        if (found < 0) or (found + FRAME_SIZE > len(data)):
+            skipped += len(data) - pos
+            return
+
+        body = data[found + len(SYNC) : found + len(SYNC) + RECORD.size]
+
+        if (sum(body) & 0xFF) != data[found + FRAME_SIZE - 1]:
+            # Not a frame, or corrupted : resync from the next byte
+            skipped += found + 1 - pos
+            pos      = found + 1
+            continue
+
+        skipped += found - pos
+        pos      = found + FRAME_SIZE
+
+        yield RECORD.unpack(body), skipped
+
+        skipped = 0
+
+
+class Clock:
+    """Unwrap the 32-bit timestamps. Records may be slightly out of order (ISR nesting, dump header)"""
+
+    def __init__(self):
+        self.last = None
+        self.ext  = 0
+
+    def extend(self, raw):
+        if self.last is None:
+            self.ext = raw
+        else:
+            delta = (raw - self.last) & 0xFFFFFFFF
+
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+
+            self.ext += delta
+
+        self.last = raw
+
+        return self.ext
+
+
+class Track:
+    """Spans of one kind on one timer"""
+
+    def __init__(self, name):
+        self.name   = name
+        self.starts = []
+        self.spans  = []        # (start, duration)
+        self.open   = None
+
+    def begin(self, t):
+        self.starts.append(t)
+        self.open = t
+
+    def end(self, t):
+        if self.open is not None:
+            self.spans.append((self.open, t - self.open))
+            self.open = None
+
+    def summary(self, ticks_per_us):
+        result = {'name': self.name, 'count': len(self.starts)}
+
+        periods = [b - a for a, b in zip(self.starts, self.starts[1:])]
+
+        if periods:
+            mean = sum(periods) / len(periods)
+
+            result['period_us']       = mean / ticks_per_us
+            result['jitter_rms_us']   = math.sqrt(sum((p - mean) ** 2 for p in periods) / len(periods)) / ticks_per_us
+            result['jitter_pp_us']    = (max(periods) - min(periods)) / ticks_per_us
+
+        if self.spans:
+            durations = [d for _, d in self.spans]
+
+            result['duration_mean_us']  = sum(durations) / len(durations) / ticks_per_us
+            result['duration_max_us']   = max(durations) / ticks_per_us
+
+            span = self.spans[-1][0] + self.spans[-1][1] - self.spans[0][0]
+
+            if span > 0:
+                result['cpu_load_pct'] = 100.0 * sum(durations) / span
+
+        return result
+
+
+def decode(data, clock_hz):
+    events  = []
+    tracks  = {}
+    clock   = Clock()
+    stats   = {'frames': 0, 'skipped': 0, 'dropped': 0}
+
+    # Set by the first CLOCK_INFO frame, unless given on the command line
+    hz = clock_hz
+
+    for (event, timer, arg1, time, arg0), skipped in read_frames(data):
+        stats['frames']  += 1
+        stats['skipped'] += skipped
+
+        t = clock.extend(time)
+
+        if event == CLOCK_INFO:
+            if hz is None:
+                hz = arg0
+            continue
+
+        if event == DROPPED:
+            stats['dropped'] += arg0
+            events.append((t, {'name': 'dropped %u' % arg0, 'ph': 'i', 's': 'g', 'pid': PID_TCB, 'tid': 0}))
+            continue
+
+        if event in SPANS:
+            _, pid, name = SPANS[event]
+            key = (pid, timer, name)
+
+            if key not in tracks:
+                tracks[key] = Track(('TCB%u %s' % (timer, name)) if pid == PID_TCB else ('ISR_Timer %u' % timer))
+
+            tracks[key].begin(t)
+
+            args = {'CNT': arg0, 'segments': arg1} if event == ISR_ENTER else {}
+
+            if event == RUN_START:
+                args = {'deadline': arg0}
+
+            events.append((t, {'name': name, 'ph': 'B', 'pid': pid, 'tid': timer, 'args': args}))
+
+        elif event in ENDS:
+            _, pid, name = SPANS[ENDS[event]]
+            key = (pid, timer, name)
+
+            if key in tracks:
+                tracks[key].end(t)
+
+            args = {'deferred': arg1} if event == RUN_END else {}
+
+            events.append((t, {'name': name, 'ph': 'E', 'pid': pid, 'tid': timer, 'args': args}))
+
+        elif event == CCMP_RELOAD:
+            events.append((t, {'name': 'CCMP reload', 'ph': 'i', 's': 't', 'pid': PID_TCB, 'tid': timer,
+                               'args': {'ticks': arg0, 'segments': arg1}}))
+
+        elif event == TIMER_DONE:
+            events.append((t, {'name': 'done', 'ph': 'i', 's': 't', 'pid': PID_TCB, 'tid': timer}))
+
+        else:
+            name = ('user %u' % (event - USER)) if event >= USER else ('event %u' % event)
+
+            events.append((t, {'name': name, 'ph': 'i', 's': 't', 'pid': PID_USER, 'tid': timer,
+                               'args': {'arg0': arg0, 'arg1': arg1}}))
+
+    if hz is None:
+        hz = 1000000
+
+    ticks_per_us = hz / 1e6
+
+    # Chrome trace timestamps are in us, from the first record
+    origin      = min((t for t, _ in events), default=0)
+    trace       = []
+    threads     = set()
+
+    for t, e in events:
+        e['ts'] = (t - origin) / ticks_per_us
+        trace.append(e)
+        threads.add((e['pid'], e['tid']))
+
+    for pid, name in ((PID_TCB, 'TimerInterrupt'), (PID_ISR_TIMER, 'ISR_Timer'), (PID_USER, 'User')):
+        trace.append({'name': 'process_name', 'ph': 'M', 'pid': pid, 'args': {'name': name}})
+
+    for pid, tid in sorted(threads):
+        name = ('TCB%u' % tid) if pid == PID_TCB else ('Timer %u' % tid)
+        trace.append({'name': 'thread_name', 'ph': 'M', 'pid': pid, 'tid': tid, 'args': {'name': name}})
+
+    summary = [tracks[key].summary(ticks_per_us) for key in sorted(tracks)]
+
+    return trace, summary, stats, hz
+
+
+def print_summary(summary, stats, hz, out):
+    out.write('Frames = %u, skipped bytes = %u, dropped records = %u, clock = %u Hz\n' %
+              (stats['frames'], stats['skipped'], stats['dropped'], hz))
+
+    out.write('%-22s %8s %12s %12s %12s %12s %12s %8s\n' %
+              ('Track', 'Count', 'Period us', 'Jitter rms', 'Jitter p-p', 'Mean us', 'Max us', 'Load %'))
+
+    def field(s, key, width=12):
+        return ('%*.2f' % (width, s[key])) if key in s else ('%*s' % (width, '-'))
+
+    for s in summary:
+        out.write('%-22s %8u %s %s %s %s %s %s\n' %
+                  (s['name'], s['count'], field(s, 'period_us'), field(s, 'jitter_rms_us'),
+                   field(s, 'jitter_pp_us'), field(s, 'duration_mean_us'), field(s, 'duration_max_us'),
+                   field(s, 'cpu_load_pct', 8)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a TISR_traceDump() capture into Chrome trace JSON')
+    parser.add_argument('capture', help='raw capture of the Serial port, - for stdin')
+    parser.add_argument('-o', '--output', help='Chrome trace JSON file, default: summary only')
+    parser.add_argument('--clock-hz', type=int, help='ticks per second of TISR_TRACE_CLOCK(), '
+                        'default: as sent by TISR_traceDump()')
+    args = parser.parse_args()
+
+    if args.capture == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, 'rb') as f:
+            data = f.read()
+
+    trace, summary, stats, hz = decode(data, args.clock_hz)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'traceEvents': trace, 'displayTimeUnit': 'ns',
+                       'otherData': {'clock_hz': hz, 'dropped': stats['dropped'], 'summary': summary}}, f)
+
+    print_summary(summary, stats, hz, sys.stdout)
+
+    return 0 if stats['frames'] else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,168 @@
+/****************************************************************************************************************************
+  TimerWheel_Benchmark.cpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  Host benchmark of TimerWheelT, megaAVR_TimerWheel.hpp being core-agnostic. Build and run from this directory :
+
+    g++ -O2 -std=gnu++11 -I../../src TimerWheel_Benchmark.cpp -o TimerWheel_Benchmark && ./TimerWheel_Benchmark
+
+  For N armed timers, measures the mean cost of a tick, i.e. one run(), with the timeout pattern of a protocol
+  stack : each tick, a few timers are deleted and set again before expiring, and a few expire. Compared with a
+  linear scan of N slots, as ISR_Timer::run() does on a tick where a timer is due.
+  Host times only show how the cost scales with N, not the cycles on AVR.
+*****************************************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <stdint.h>
+
+#include "megaAVR_TimerWheel.hpp"
+
+#define NUM_TICKS           1000000UL
+
+// Timers deleted and set again per tick
+#define CHURN_PER_TICK      4
+
+// Timeouts, in ticks
+#define MIN_TIMEOUT         1000
+#define MAX_TIMEOUT         30000
+
+static volatile uint32_t expired = 0;
+
+static void onTimeout(void* param)
+{
+  (void) param;
+  expired++;
+}
+
+// xorshift32, cheaper than rand(), not to hide the cost of the timers
+static uint32_t randomState;
+
+static uint32_t random32()
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+
+  return randomState;
+}
+
+static uint32_t randomTimeout()
+{
+  return MIN_TIMEOUT + (random32() % (MAX_TIMEOUT - MIN_TIMEOUT));
+}
+
+// ns per tick, with numTimers armed
+template<uint16_t POOL>
+static double benchWheel(const uint16_t numTimers)
+{
+  static TimerWheelT<POOL> wheel;
+  static int ids[POOL];
+
+  wheel.init();
+  randomState = 1;
+
+  for (uint16_t i = 0; i < numTimers; i++)
+    ids[i] = wheel.setTimeout(randomTimeout(), onTimeout, NULL);
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t tick = 0; tick < NUM_TICKS; tick++)
+  {
+    for (uint8_t c = 0; c < CHURN_PER_TICK; c++)
+    {
+      uint16_t i = random32() % numTimers;
+
+      // Activity on a connection : its timeout starts again. Expired ones are set again too
+      wheel.deleteTimer(ids[i]);
+      ids[i] = wheel.setTimeout(randomTimeout(), onTimeout, NULL);
+    }
+
+    wheel.run();
+  }
+
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / NUM_TICKS;
+}
+
+// Same load, with a linear scan of all slots per tick
+typedef struct
+{
+  uint32_t prev;
+  uint32_t delay;
+  bool     used;
+} slot_t;
+
+template<uint16_t POOL>
+static double benchScan(const uint16_t numTimers)
+{
+  static slot_t slots[POOL];
+
+  randomState = 1;
+
+  for (uint16_t i = 0; i < numTimers; i++)
+  {
+    slots[i].prev   = 0;
+    slots[i].delay  = randomTimeout();
+    slots[i].used   = true;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t tick = 0; tick < NUM_TICKS; tick++)
+  {
+    for (uint8_t c = 0; c < CHURN_PER_TICK; c++)
+    {
+      uint16_t i = random32() % numTimers;
+
+      slots[i].prev   = tick;
+      slots[i].delay  = randomTimeout();
+      slots[i].used   = true;
+    }
+
+    for (uint16_t i = 0; i < numTimers; i++)
+    {
+      if ( slots[i].used && ((tick - slots[i].prev) >= slots[i].delay) )
+      {
+        slots[i].used = false;
+        onTimeout(NULL);
+      }
+    }
+  }
+
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / NUM_TICKS;
+}
+
+template<uint16_t POOL>
+static void benchmark()
+{
+  expired = 0;
+  double wheel = benchWheel<POOL>(POOL);
+  uint32_t wheelExpired = expired;
+
+  expired = 0;
+  double scan = benchScan<POOL>(POOL);
+
+  printf("%6u timers : wheel %7.1f ns/tick (%u expired), linear scan %8.1f ns/tick\n", POOL, wheel,
+         (unsigned) wheelExpired, scan);
+}
+
+int main()
+{
+  printf("%lu ticks, %u timeouts deleted and set again per tick, timeouts %u to %u ticks\n", NUM_TICKS,
+         CHURN_PER_TICK, MIN_TIMEOUT, MAX_TIMEOUT);
+
+  benchmark<16>();
+  benchmark<64>();
+  benchmark<256>();
+  benchmark<1024>();
+
+  return 0;
+}
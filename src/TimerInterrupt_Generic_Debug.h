@@ -97,4 +97,316 @@ const char TISR_SP[]    = " ";
 
 ///////////////////////////////////////
 
+// Trace ring. The TISR_LOG* macros print at once, which must not be done in an ISR: Serial.print() blocks
+// as soon as its TX buffer is full, and the TX interrupt can't run inside the ISR.
+// The TISR_TRACE* macros instead store a fixed size binary record in a RAM ring, to be formatted and printed
+// later from loop() by TISR_tracePrint(). Same levels as _TIMERINTERRUPT_LOGLEVEL_, but set apart.
+// A trace point above TISR_TRACE_LEVEL produces no code at all, and with TISR_TRACE_LEVEL 0 (default)
+// neither the ring nor the functions are compiled.
+//
+// Select before #include "megaAVR_TimerInterrupt.h", e.g.
+//   #define TISR_TRACE_LEVEL        4
+//   #define TISR_TRACE_SIZE         64        // Power of 2, holds 63 records of 12 bytes
+//   uint32_t traceClock();                    // Defined later, e.g. returning ITimeStamp2.now()
+//   #define TISR_TRACE_CLOCK()      traceClock()
+
+#ifndef TISR_TRACE_LEVEL
+  #define TISR_TRACE_LEVEL        0
+#endif
+
+#ifndef TISR_TRACE_SIZE
+  #define TISR_TRACE_SIZE         32
+#endif
+
+// Timestamp of the records. Any expression returning uint32_t and declared before the library is included
+#ifndef TISR_TRACE_CLOCK
+  #define TISR_TRACE_CLOCK()      micros()
+#endif
+
+// Ticks per second of TISR_TRACE_CLOCK(), sent by TISR_traceDump() for the host decoder
+#ifndef TISR_TRACE_CLOCK_HZ
+  #define TISR_TRACE_CLOCK_HZ     1000000UL
+#endif
+
+// Event ids of the library trace points. Applications use TISR_TRACE_USER and up
+#define TISR_TRACE_TIMER_DONE     1         // TimerInterrupt duration over, timer detached
+#define TISR_TRACE_ISR_ENTER      3         // arg0 = CNT at entry, arg1 = segments remaining
+#define TISR_TRACE_ISR_EXIT       4
+#define TISR_TRACE_CALLBACK_START 5
+#define TISR_TRACE_CALLBACK_END   6
+#define TISR_TRACE_CCMP_RELOAD    7         // reloadTicks(), arg0 = new period in ticks, arg1 = segments
+#define TISR_TRACE_RUN_START      8         // ISR_Timer::run() dispatch, timer = ISR_Timer timer number
+#define TISR_TRACE_RUN_END        9         //   arg1 = 1 if posted to the event queue
+
+// Sent by TISR_traceDump() only
+#define TISR_TRACE_CLOCK_INFO     0x70      // arg0 = TISR_TRACE_CLOCK_HZ
+#define TISR_TRACE_DROPPED        0x71      // arg0 = records dropped since the last dump
+
+#define TISR_TRACE_USER           0x80
+
+// Binary frame of TISR_traceDump(): 2 sync bytes, the 12 bytes of tisr_trace_t (little endian, no padding:
+// event, timer, arg1, time, arg0), then the 8-bit sum of these 12 bytes.
+// Decoded by extras/TimerTrace/tisr_trace.py
+#define TISR_TRACE_SYNC0          0xA5
+#define TISR_TRACE_SYNC1          0x5A
+
+#if (TISR_TRACE_LEVEL > 0)
+
+#include <Arduino.h>
+
+#if ( (TISR_TRACE_SIZE < 2) || (TISR_TRACE_SIZE > 128) || (TISR_TRACE_SIZE & (TISR_TRACE_SIZE - 1)) )
+  #error TISR_TRACE_SIZE must be a power of 2, from 2 to 128
+#endif
+
+typedef struct
+{
+  uint8_t   event;
+  uint8_t   timer;
+  uint16_t  arg1;
+  uint32_t  time;
+  uint32_t  arg0;
+} tisr_trace_t;
+
+typedef struct
+{
+  tisr_trace_t      records[TISR_TRACE_SIZE];
+  volatile uint8_t  head;
+  volatile uint8_t  tail;
+  volatile uint16_t dropped;
+} tisr_trace_ring_t;
+
+// Function-local static, so that there is a single ring even if the headers are included in many files
+inline tisr_trace_ring_t& TISR_traceRing()
+{
+  static tisr_trace_ring_t ring;
+
+  return ring;
+}
+
+// Safe from ISRs and loop(). When the ring is full the new record is dropped and counted
+inline void TISR_traceRecord(const uint8_t event, const uint8_t timer, const uint32_t arg0, const uint16_t arg1)
+{
+  uint32_t time = TISR_TRACE_CLOCK();
+
+  tisr_trace_ring_t& ring = TISR_traceRing();
+
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  uint8_t head = ring.head;
+  uint8_t next = (head + 1) & (TISR_TRACE_SIZE - 1);
+
+  if (next == ring.tail)
+  {
+    if (ring.dropped != 0xFFFF)
+      ring.dropped++;
+  }
+  else
+  {
+    tisr_trace_t* record = &ring.records[head];
+
+    record->event = event;
+    record->timer = timer;
+    record->arg1  = arg1;
+    record->time  = time;
+    record->arg0  = arg0;
+
+    ring.head = next;
+  }
+
+  SREG = sreg;
+}
+
+// Copy the oldest record out of the ring. Return false if it is empty
+inline bool TISR_traceRead(tisr_trace_t& record)
+{
+  tisr_trace_ring_t& ring = TISR_traceRing();
+
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  uint8_t tail = ring.tail;
+
+  if (tail == ring.head)
+  {
+    SREG = sreg;
+
+    return false;
+  }
+
+  record    = ring.records[tail];
+  ring.tail = (tail + 1) & (TISR_TRACE_SIZE - 1);
+
+  SREG = sreg;
+
+  return true;
+}
+
+// Records dropped since the last call, and reset the count
+inline uint16_t TISR_traceDropped()
+{
+  tisr_trace_ring_t& ring = TISR_traceRing();
+
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  uint16_t dropped = ring.dropped;
+  ring.dropped = 0;
+
+  SREG = sreg;
+
+  return dropped;
+}
+
+// Format and print up to maxRecords records (0 = all) to TISR_DBG_PORT. Call from loop(), never from an ISR.
+// Return the number of records printed
+inline uint16_t TISR_tracePrint(const uint16_t maxRecords = 0)
+{
+  tisr_trace_t record;
+  uint16_t     count = 0;
+
+  uint16_t dropped = TISR_traceDropped();
+
+  if (dropped != 0)
+  {
+    TISR_PRINT_MARK; TISR_PRINT(F("Trace dropped = ")); TISR_PRINTLN(dropped);
+  }
+
+  while ( ( (maxRecords == 0) || (count < maxRecords) ) && TISR_traceRead(record) )
+  {
+    TISR_PRINT_MARK;
+    TISR_PRINT(record.time);
+    TISR_PRINT(F(" TCB"));
+    TISR_PRINT(record.timer);
+    TISR_PRINT_SP;
+
+    switch (record.event)
+    {
+      case TISR_TRACE_TIMER_DONE:
+        TISR_PRINT(F("Done"));
+        break;
+
+      case TISR_TRACE_ISR_ENTER:
+        TISR_PRINT(F("ISR enter"));
+        break;
+
+      case TISR_TRACE_ISR_EXIT:
+        TISR_PRINT(F("ISR exit"));
+        break;
+
+      case TISR_TRACE_CALLBACK_START:
+        TISR_PRINT(F("Callback start"));
+        break;
+
+      case TISR_TRACE_CALLBACK_END:
+        TISR_PRINT(F("Callback end"));
+        break;
+
+      case TISR_TRACE_CCMP_RELOAD:
+        TISR_PRINT(F("CCMP reload"));
+        break;
+
+      case TISR_TRACE_RUN_START:
+        TISR_PRINT(F("Run start"));
+        break;
+
+      case TISR_TRACE_RUN_END:
+        TISR_PRINT(F("Run end"));
+        break;
+
+      default:
+        TISR_PRINT(F("Event "));
+        TISR_PRINT(record.event);
+        break;
+    }
+
+    TISR_PRINT_SP; TISR_PRINT(record.arg0);
+    TISR_PRINT_SP; TISR_PRINTLN(record.arg1);
+
+    count++;
+  }
+
+  return count;
+}
+
+inline void TISR_traceWriteFrame(const tisr_trace_t& record)
+{
+  const uint8_t* bytes = (const uint8_t*) &record;
+  uint8_t        sum   = 0;
+
+  for (uint8_t i = 0; i < sizeof(tisr_trace_t); i++)
+    sum += bytes[i];
+
+  TISR_DBG_PORT.write(TISR_TRACE_SYNC0);
+  TISR_DBG_PORT.write(TISR_TRACE_SYNC1);
+  TISR_DBG_PORT.write(bytes, sizeof(tisr_trace_t));
+  TISR_DBG_PORT.write(sum);
+}
+
+// Binary counterpart of TISR_tracePrint(), much faster to send and decoded on the host into a timeline.
+// Starts with a TISR_TRACE_CLOCK_INFO frame, and a TISR_TRACE_DROPPED frame if records were lost.
+// Call from loop(), never from an ISR. Return the number of records sent
+inline uint16_t TISR_traceDump(const uint16_t maxRecords = 0)
+{
+  tisr_trace_t record;
+  uint16_t     count = 0;
+
+  record.event  = TISR_TRACE_CLOCK_INFO;
+  record.timer  = 0;
+  record.arg1   = 0;
+  record.time   = TISR_TRACE_CLOCK();
+  record.arg0   = TISR_TRACE_CLOCK_HZ;
+
+  TISR_traceWriteFrame(record);
+
+  uint16_t dropped = TISR_traceDropped();
+
+  if (dropped != 0)
+  {
+    record.event  = TISR_TRACE_DROPPED;
+    record.arg0   = dropped;
+
+    TISR_traceWriteFrame(record);
+  }
+
+  while ( ( (maxRecords == 0) || (count < maxRecords) ) && TISR_traceRead(record) )
+  {
+    TISR_traceWriteFrame(record);
+
+    count++;
+  }
+
+  return count;
+}
+
+#endif    // (TISR_TRACE_LEVEL > 0)
+
+///////////////////////////////////////
+
+#if (TISR_TRACE_LEVEL > 0)
+  #define TISR_TRACEERROR(event, timer, arg0, arg1)   TISR_traceRecord(event, timer, arg0, arg1)
+#else
+  #define TISR_TRACEERROR(event, timer, arg0, arg1)
+#endif
+
+#if (TISR_TRACE_LEVEL > 1)
+  #define TISR_TRACEWARN(event, timer, arg0, arg1)    TISR_traceRecord(event, timer, arg0, arg1)
+#else
+  #define TISR_TRACEWARN(event, timer, arg0, arg1)
+#endif
+
+#if (TISR_TRACE_LEVEL > 2)
+  #define TISR_TRACEINFO(event, timer, arg0, arg1)    TISR_traceRecord(event, timer, arg0, arg1)
+#else
+  #define TISR_TRACEINFO(event, timer, arg0, arg1)
+#endif
+
+#if (TISR_TRACE_LEVEL > 3)
+  #define TISR_TRACEDEBUG(event, timer, arg0, arg1)   TISR_traceRecord(event, timer, arg0, arg1)
+#else
+  #define TISR_TRACEDEBUG(event, timer, arg0, arg1)
+#endif
+
+///////////////////////////////////////
+
 #endif    //TIMERINTERRUPT_GENERIC_DEBUG_H
@@ -0,0 +1,141 @@
+/****************************************************************************************************************************
+  megaAVR_ADCSampler-Impl.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  ADCSampler streams ADC0 conversions at an exact rate. A TCB, through the Event System, starts each conversion,
+  without any CPU ISR. The ADC result-ready ISR stores samples, of one or more channels in round-robin sequence,
+  into a ring of blocks, and loop() consumes the full blocks.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_ADCSAMPLER_IMPL_H
+#define MEGA_AVR_ADCSAMPLER_IMPL_H
+
+#ifndef TIMER_INTERRUPT_DEBUG
+  #define TIMER_INTERRUPT_DEBUG      0
+#endif
+
+bool ADCSampler::begin(TimerInterrupt& timer, const uint8_t& evsysChannel, const uint32_t& rate,
+                       const uint8_t channels[], const uint8_t& numChannels)
+{
+  if ( (rate == 0) || (numChannels == 0) || (numChannels > ADC_SAMPLER_MAX_CHANNELS) ||
+       ( (ADC_SAMPLER_BLOCK_SIZE % numChannels) != 0 ) )
+  {
+    TISR_LOGERROR1(F("ADCSampler: invalid rate or channels, numChannels ="), numChannels);
+
+    return false;
+  }
+
+  // The ADC ignores triggers while converting, so a higher rate would drop samples
+  if (rate > getMaxRate())
+  {
+    TISR_LOGERROR3(F("ADCSampler: rate ="), rate, F(", above the max rate of ADC0 ="), getMaxRate());
+
+    return false;
+  }
+
+  end();
+
+  noInterrupts();
+
+  _timer        = &timer;
+  _numChannels  = numChannels;
+  _channelIndex = 0;
+  _index        = 0;
+  _head         = 0;
+  _tail         = 0;
+  _samples      = 0;
+  _overruns     = 0;
+
+  for (uint8_t i = 0; i < numChannels; i++)
+    _channels[i] = channels[i];
+
+  // ADC0 keeps the reference, prescaler and resolution set by the core. Each conversion is started by the event
+  ADC0.CTRLA    |= ADC_ENABLE_bm;
+  ADC0.MUXPOS   = channels[0];
+  ADC0.EVCTRL   = ADC_STARTEI_bm;
+  ADC0.INTFLAGS = ADC_RESRDY_bm;
+  ADC0.INTCTRL  = ADC_RESRDY_bm;
+
+  TimerInterrupt_setEventUser(EVSYS.USERADC0, evsysChannel);
+
+  interrupts();
+
+  // Event-only timer, no callback and no TCB interrupt. Period first : setEventOutput() checks the current one,
+  // which may be a long period left by a previous use of timer
+  if ( !timer.setIntervalNs( ( 1000000000UL + (rate / 2) ) / rate, (timer_callback) NULL) ||
+       !timer.setEventOutput(evsysChannel) )
+  {
+    TISR_LOGERROR1(F("ADCSampler: can't set timer for rate ="), rate);
+
+    end();
+
+    return false;
+  }
+
+  // Stopped by end(), e.g. of a previous begin(), maybe with CNT above the new CCMP : restart from 0
+  noInterrupts();
+  TimerTCB[timer.getTimer()]->CNT = 0;
+  interrupts();
+
+  timer.enableTimer();
+
+  _startTime = millis();
+
+  TISR_LOGWARN3(F("ADCSampler: rate ="), getTimerRate(), F(", channels ="), numChannels);
+
+  return true;
+}
+
+void ADCSampler::end()
+{
+  noInterrupts();
+
+  if (_timer != NULL)
+  {
+    _timer->detachInterrupt();
+    _timer->clearEventOutput();
+    _timer = NULL;
+  }
+
+  EVSYS.USERADC0  = 0;
+  ADC0.EVCTRL     = 0;
+  ADC0.INTCTRL    = 0;
+  ADC0.INTFLAGS   = ADC_RESRDY_bm;
+
+  interrupts();
+}
+
+////////////////////////////////////////////////////////
+
+#ifndef ADC_SAMPLER_INSTANTIATED
+// To force pre-instatiate only once
+#define ADC_SAMPLER_INSTANTIATED
+ADCSampler ADCSampler0;
+
+ISR(ADC0_RESRDY_vect)
+{
+  ADCSampler0.handleInterrupt();
+}
+#endif  //#ifndef ADC_SAMPLER_INSTANTIATED
+
+#endif // MEGA_AVR_ADCSAMPLER_IMPL_H
@@ -0,0 +1,236 @@
+/****************************************************************************************************************************
+  megaAVR_ADCSampler.hpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  ADCSampler streams ADC0 conversions at an exact rate. A TCB, through the Event System, starts each conversion,
+  without any CPU ISR. The ADC result-ready ISR stores samples, of one or more channels in round-robin sequence,
+  into a ring of blocks, and loop() consumes the full blocks.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_ADCSAMPLER_HPP
+#define MEGA_AVR_ADCSAMPLER_HPP
+
+#include "megaAVR_TimerInterrupt.hpp"
+
+#ifndef ADC_SAMPLER_BLOCK_SIZE
+  // Samples per block. Must be a multiple of the number of channels
+  #define ADC_SAMPLER_BLOCK_SIZE      32
+#endif
+
+#ifndef ADC_SAMPLER_NUM_BLOCKS
+  // Blocks in the ring, one being filled by the ISR while the others wait for loop(). 2 => double buffer
+  #define ADC_SAMPLER_NUM_BLOCKS      2
+#endif
+
+#ifndef ADC_SAMPLER_MAX_CHANNELS
+  #define ADC_SAMPLER_MAX_CHANNELS    8
+#endif
+
+#if ( (ADC_SAMPLER_NUM_BLOCKS < 2) || (ADC_SAMPLER_NUM_BLOCKS > 255) )
+  #error ADC_SAMPLER_NUM_BLOCKS must be from 2 to 255
+#endif
+
+class ADCSampler
+{
+  private:
+
+    TimerInterrupt*   _timer;
+    uint8_t           _channels[ ADC_SAMPLER_MAX_CHANNELS ];    // ADC_MUXPOS_AINn_gc, in conversion order
+    uint8_t           _numChannels;
+    uint8_t           _channelIndex;      // in _channels[], of the conversion running. ISR only
+
+    uint16_t          _blocks[ ADC_SAMPLER_NUM_BLOCKS ][ ADC_SAMPLER_BLOCK_SIZE ];
+    uint16_t          _index;             // in the block being filled. ISR only
+
+    // Single-producer (ISR), single-consumer (loop()) ring of blocks. _head is the block being filled,
+    // written by the ISR only. _tail is the oldest full block, written by releaseBlock() only
+    volatile uint8_t  _head;
+    volatile uint8_t  _tail;
+
+    volatile uint32_t _samples;           // conversions since begin()
+    volatile uint16_t _overruns;          // full blocks dropped because loop() didn't release a block in time
+    unsigned long     _startTime;         // millis() at begin()
+
+    // Read a multi-byte counter updated by the ISR, without disabling interrupts
+    uint32_t readSamples()
+    {
+      uint32_t samples;
+
+      do
+      {
+        samples = _samples;
+      } while (samples != _samples);
+
+      return samples;
+    }
+
+  public:
+
+    ADCSampler()
+    {
+      _timer        = NULL;
+      _numChannels  = 0;
+      _channelIndex = 0;
+      _index        = 0;
+      _head         = 0;
+      _tail         = 0;
+      _samples      = 0;
+      _overruns     = 0;
+      _startTime    = 0;
+    };
+
+    // Start conversions at rate (in Hz, all channels together, e.g. 2 channels at 1000Hz each => 2000),
+    // triggered by the compare event of timer through EVSYS channel evsysChannel. The period must fit in one TCB
+    // segment, 65536 ticks of TCB_CLKSEL_CLKTCA_gc : lowest rate is F_CPU / 64 / 65536, i.e. 4Hz (3.81Hz) at 16MHz
+    // and 5Hz (4.77Hz) at 20MHz. Returns false below it, and above getMaxRate().
+    // channels[] are ADC_MUXPOS_AINn_gc values, converted in round-robin sequence, so that sample i of each block
+    // is from channels[i % numChannels]. timer can't be used for anything else. analogRead() can't be used meanwhile
+    bool begin(TimerInterrupt& timer, const uint8_t& evsysChannel, const uint32_t& rate,
+               const uint8_t channels[], const uint8_t& numChannels);
+
+    // Stop the timer and the conversions
+    void end();
+
+    // Highest rate (in Hz, all channels together) of conversions, as set up by the core or the sketch : one conversion
+    // takes 13 ADC clocks (11 at 8-bit resolution) + SAMPCTRL.SAMPLEN + CTRLD.SAMPDLY (its max if CTRLD.ASDV), of
+    // CLK_PER / CTRLC prescaler, i.e. 9615Hz (DIV128, the core default) at 16MHz. A trigger during a conversion is lost
+    uint32_t getMaxRate()
+    {
+      uint32_t adcClocks = ( (ADC0.CTRLA & ADC_RESSEL_bm) ? 11 : 13 ) + (ADC0.SAMPCTRL & ADC_SAMPLEN_gm) +
+                           ( (ADC0.CTRLD & ADC_ASDV_bm) ? ADC_SAMPDLY_gm : (ADC0.CTRLD & ADC_SAMPDLY_gm) );
+
+      return F_CPU / ( adcClocks * (2UL << (ADC0.CTRLC & ADC_PRESC_gm)) );
+    }
+
+    // Oldest full block, of ADC_SAMPLER_BLOCK_SIZE samples, or NULL if none. Valid until releaseBlock()
+    const uint16_t* getBlock()
+    {
+      uint8_t tail = _tail;
+
+      if (tail == _head)
+        return NULL;
+
+      // Samples written by the ISR before it moved _head must be read from memory
+      __asm__ __volatile__ ("" ::: "memory");
+
+      return _blocks[tail];
+    }
+
+    // Give back the block from getBlock() to the ISR
+    void releaseBlock()
+    {
+      uint8_t tail = _tail;
+
+      if (tail == _head)
+        return;
+
+      // Done reading the block before the ISR can write it
+      __asm__ __volatile__ ("" ::: "memory");
+
+      _tail = (tail + 1) % ADC_SAMPLER_NUM_BLOCKS;
+    }
+
+    // Number of full blocks waiting for getBlock()
+    uint8_t available()
+    {
+      return (uint8_t) ( ( _head + ADC_SAMPLER_NUM_BLOCKS - _tail ) % ADC_SAMPLER_NUM_BLOCKS );
+    }
+
+    // Number of full blocks dropped because no block was released in time
+    uint16_t getOverruns()
+    {
+      uint16_t overruns;
+
+      do
+      {
+        overruns = _overruns;
+      } while (overruns != _overruns);
+
+      return overruns;
+    }
+
+    // Conversions since begin()
+    uint32_t getSampleCount()
+    {
+      return readSamples();
+    }
+
+    // Sustained rate (in Hz, all channels together) measured since begin()
+    uint32_t getSampleRate()
+    {
+      unsigned long elapsed = millis() - _startTime;
+
+      return (elapsed == 0) ? 0 : (uint32_t) ( ( (uint64_t) readSamples() * 1000 ) / elapsed );
+    }
+
+    // Rate (in Hz, all channels together) achieved by the timer, truncated
+    uint32_t getTimerRate()
+    {
+      return ( (_timer == NULL) || (_timer->get_CCMPValue() == 0) ) ? 0 :
+             _timer->getClockFrequency() / _timer->get_CCMPValue();
+    }
+
+    uint8_t getNumChannels()
+    {
+      return _numChannels;
+    }
+
+    // Called from ISR(ADC0_RESRDY_vect) only
+    __attribute__((always_inline)) void handleInterrupt()
+    {
+      // Reading RES clears the interrupt flag
+      uint16_t sample = ADC0.RES;
+
+      // Select the next channel before the next trigger
+      if (_numChannels > 1)
+      {
+        uint8_t channelIndex = _channelIndex + 1;
+
+        if (channelIndex == _numChannels)
+          channelIndex = 0;
+
+        _channelIndex = channelIndex;
+        ADC0.MUXPOS   = _channels[channelIndex];
+      }
+
+      uint8_t head = _head;
+
+      _blocks[head][_index] = sample;
+      _samples++;
+
+      if (++_index == ADC_SAMPLER_BLOCK_SIZE)
+      {
+        _index = 0;
+
+        uint8_t next = (head + 1) % ADC_SAMPLER_NUM_BLOCKS;
+
+        // Ring full : refill the same block, dropping its samples
+        if (next == _tail)
+          _overruns++;
+        else
+          _head = next;
+      }
+    }
+}; // class ADCSampler
+
+#endif      // MEGA_AVR_ADCSAMPLER_HPP
@@ -34,93 +34,175 @@
 
 #include <string.h>
 
-// Select time function:
-//static inline unsigned long elapsed() { return micros(); }
-static inline unsigned long elapsed()
+template<uint8_t N>
+ISR_TimerT<N>::ISR_TimerT()
+  : usedMask (0), enabledMask (0), dueMask (0), paramMask (0), ranMask (0), deferMask (0), eventQueue (NULL), numTimers (-1), deadlineBase (0), deadlineDelta (0),
+    deadlineValid (false), hwTimer (NULL), timeStamp (NULL), unitsPerSecond (1000), minTicks (1), tickBase (0), inRun (false), runTime (0)
 {
-  return millis();
 }
 
+template<uint8_t N>
+unsigned long ISR_TimerT<N>::now()
+{
+  // Same time for all timers run by the ISR
+  if (inRun)
+    return runTime;
+
+  return currentTime();
+}
 
-ISR_Timer::ISR_Timer()
-  : numTimers (-1)
+// Select time function: millis(), ticks of timeStamp, or ticks of hwTimer in tickless mode
+template<uint8_t N>
+unsigned long ISR_TimerT<N>::currentTime()
 {
+  if (hwTimer == NULL)
+    return (timeStamp == NULL) ? millis() : timeStamp->now();
+
+  // From runTickless(), with CCMP parked at 0xFFFF
+  if (inRun)
+    return tickBase + ticklessCount();
+
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  unsigned long current = tickBase + hwTimer->getElapsedTicks();
+
+  SREG = sreg;
+
+  return current;
 }
 
-void ISR_Timer::init()
+template<uint8_t N>
+void ISR_TimerT<N>::init()
 {
-  unsigned long current_millis = millis();   //elapsed();
+  unsigned long current_millis = now();
 
   for (uint8_t i = 0; i < MAX_TIMERS; i++)
   {
     memset((void*) &timer[i], 0, sizeof (timer_t));
     timer[i].prev_millis = current_millis;
+
+#if ISR_TIMER_USE_STATS
+    TimerInterrupt_resetStats(stats[i]);
+#endif
   }
 
+  usedMask    = 0;
+  enabledMask = 0;
+  dueMask     = 0;
+  paramMask   = 0;
+  ranMask     = 0;
+  deferMask   = 0;
+
   numTimers = 0;
+
+  deadlineValid = false;
 }
 
 
-void ISR_Timer::run()
+template<uint8_t N>
+void ISR_TimerT<N>::runTimers(const unsigned long current_millis)
 {
   uint8_t i;
-  unsigned long current_millis;
 
-  // get current time
-  current_millis = millis();   //elapsed();
+  // Time to the earliest next deadline, from current_millis
+  unsigned long nextDelta = 0xFFFFFFFFUL;
 
-  for (i = 0; i < MAX_TIMERS; i++)
+  timer_mask_t due      = 0;
+  timer_mask_t lastRun  = 0;      // due timers to be deleted after their callback
+
+  // no callback == no timer, i.e. jump over empty slots
+  for (timer_mask_t pending = usedMask; pending != 0; pending &= pending - 1)
   {
-    timer[i].toBeCalled = DEFCALL_DONTRUN;
+    i = firstSlotOf(pending);
+
+    timer_mask_t bit = (timer_mask_t) 1 << i;
 
-    // no callback == no timer, i.e. jump over empty slots
-    if (timer[i].callback != NULL)
+    // is it time to process this timer ?
+    // see http://arduino.cc/forum/index.php/topic,124048.msg932592.html#msg932592
+
+    if ((current_millis - timer[i].prev_millis) >= timer[i].delay)
     {
-      // is it time to process this timer ?
-      // see http://arduino.cc/forum/index.php/topic,124048.msg932592.html#msg932592
+      unsigned long skipTimes = (current_millis - timer[i].prev_millis) / timer[i].delay;
+      // update time
+      timer[i].prev_millis += timer[i].delay * skipTimes;
 
-      if ((current_millis - timer[i].prev_millis) >= timer[i].delay)
+      // check if the timer callback has to be executed
+      if (enabledMask & bit)
       {
-        unsigned long skipTimes = (current_millis - timer[i].prev_millis) / timer[i].delay;
-        // update time
-        timer[i].prev_millis += timer[i].delay * skipTimes;
+        // "run forever" timers must always be executed
+        due |= bit;
+
+#if ISR_TIMER_USE_STATS
+        if (skipTimes > 1)
+          TimerInterrupt_addMissed(stats[i], skipTimes - 1);
+#endif
 
-        // check if the timer callback has to be executed
-        if (timer[i].enabled)
+        // other timers get executed the specified number of times
+        if (timer[i].runsLeft != RUN_FOREVER)
         {
-          // "run forever" timers must always be executed
-          if (timer[i].maxNumRuns == RUN_FOREVER)
-          {
-            timer[i].toBeCalled = DEFCALL_RUNONLY;
-          }
-          // other timers get executed the specified number of times
-          else if (timer[i].numRuns < timer[i].maxNumRuns)
+          ranMask |= bit;
+
+          // after the last run, delete the timer
+          if (--timer[i].runsLeft == 0)
           {
-            timer[i].toBeCalled = DEFCALL_RUNONLY;
-            timer[i].numRuns++;
-
-            // after the last run, delete the timer
-            if (timer[i].numRuns >= timer[i].maxNumRuns)
-            {
-              timer[i].toBeCalled = DEFCALL_RUNANDDEL;
-            }
+            lastRun |= bit;
           }
         }
       }
     }
+
+    // Disabled timers are kept, as their prev_millis still moves on
+    unsigned long remaining = timer[i].delay - (current_millis - timer[i].prev_millis);
+
+    if (remaining < nextDelta)
+      nextDelta = remaining;
   }
 
-  for (i = 0; i < MAX_TIMERS; i++)
+  // Set before the callbacks, which may add or change timers and clear deadlineValid.
+  // Timers deleted meanwhile leave an early deadline, only costing one more scan
+  deadlineBase  = current_millis;
+  deadlineDelta = nextDelta;
+  deadlineValid = true;
+
+  // A timer deleted by a callback is removed from dueMask, so not called afterwards
+  dueMask = due;
+
+  while (dueMask != 0)
   {
-    if (timer[i].toBeCalled == DEFCALL_DONTRUN)
-      continue;
+    i = firstSlotOf(dueMask);
+
+    timer_mask_t bit = (timer_mask_t) 1 << i;
+
+    dueMask &= ~bit;
+
+#if ISR_TIMER_USE_STATS
+    unsigned long deadline  = timer[i].prev_millis;
+    unsigned long start     = currentTime();
+#endif
 
-    if (timer[i].hasParam)
+    TISR_TRACEDEBUG(TISR_TRACE_RUN_START, i, timer[i].prev_millis, 0);
+
+    if ( (deferMask & bit) && (eventQueue != NULL) )
+    {
+      // Dropped if the queue is full, as counted by eventQueue->getDropped()
+      if (paramMask & bit)
+        eventQueue->post((timer_callback_p)timer[i].callback, timer[i].param, i);
+      else
+        eventQueue->post((timer_callback)timer[i].callback, i);
+    }
+    else if (paramMask & bit)
       (*(timer_callback_p)timer[i].callback)(timer[i].param);
     else
       (*(timer_callback)timer[i].callback)();
 
-    if (timer[i].toBeCalled == DEFCALL_RUNANDDEL)
+    TISR_TRACEDEBUG(TISR_TRACE_RUN_END, i, 0, ( (deferMask & bit) && (eventQueue != NULL) ) ? 1 : 0);
+
+#if ISR_TIMER_USE_STATS
+    TimerInterrupt_addStats(stats[i], start - deadline, currentTime() - start);
+#endif
+
+    if (lastRun & bit)
       deleteTimer(i);
   }
 }
@@ -128,7 +210,8 @@ void ISR_Timer::run()
 
 // find the first available slot
 // return -1 if none found
-int ISR_Timer::findFirstFreeSlot()
+template<uint8_t N>
+int ISR_TimerT<N>::findFirstFreeSlot()
 {
   // all slots are used
   if (numTimers >= MAX_TIMERS)
@@ -137,20 +220,71 @@ int ISR_Timer::findFirstFreeSlot()
   }
 
   // return the first slot with no callback (i.e. free)
-  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+  timer_mask_t freeMask = (timer_mask_t) ~usedMask;
+
+  // no free slots found
+  if (freeMask == 0)
   {
-    if (timer[i].callback == NULL)
-    {
-      return i;
-    }
+    return -1;
   }
 
-  // no free slots found
-  return -1;
+  return firstSlotOf(freeMask);
+}
+
+
+template<uint8_t N>
+bool ISR_TimerT<N>::toUnits(const unsigned long& value, const unsigned long& perSecond, unsigned long& u)
+{
+  // Timers in ms, without tickless mode or TimeStamp : a delay in us must be a whole number of ms, as rounding it
+  // would change it by up to 0.5ms, e.g. 200us into a 1ms timer
+  if ( (hwTimer == NULL) && (timeStamp == NULL) && (perSecond > unitsPerSecond) &&
+       ( (value % (perSecond / unitsPerSecond)) != 0 ) )
+  {
+    TISR_LOGERROR(F("ISR_Timer: delay not in whole ms without tickless mode or TimeStamp"));
+    return false;
+  }
+
+  // ms, without tickless mode
+  if (perSecond == unitsPerSecond)
+  {
+    u = value;
+
+    return true;
+  }
+
+  // Only when setting timers, so 64-bit is OK
+  uint64_t units = ( ( (uint64_t) value * unitsPerSecond ) + (perSecond / 2) ) / perSecond;
+
+  if (units > 0xFFFFFFFFUL)
+  {
+    TISR_LOGERROR(F("ISR_Timer: delay too long"));
+    return false;
+  }
+
+  // Not rounded down to 0
+  u = ( (units == 0) && (value != 0) ) ? 1 : (unsigned long) units;
+
+  return true;
+}
+
+
+template<uint8_t N>
+int ISR_TimerT<N>::setupTimer(const unsigned long& d, void* f, void* p, bool h, const unsigned& n,
+                              const unsigned long& perSecond)
+{
+  unsigned long u;
+
+  if (!toUnits(d, perSecond, u))
+  {
+    return -1;
+  }
+
+  return setupTimerUnits(u, f, p, h, n);
 }
 
 
-int ISR_Timer::setupTimer(const unsigned long& d, void* f, void* p, bool h, const unsigned& n)
+template<uint8_t N>
+int ISR_TimerT<N>::setupTimerUnits(const unsigned long& u, void* f, void* p, bool h, const unsigned& n)
 {
   int freeTimer;
 
@@ -171,51 +305,147 @@ int ISR_Timer::setupTimer(const unsigned long& d, void* f, void* p, bool h, cons
     return -1;
   }
 
-  timer[freeTimer].delay        = d;
+  timer[freeTimer].delay        = u;
   timer[freeTimer].callback     = f;
   timer[freeTimer].param        = p;
-  timer[freeTimer].hasParam     = h;
-  timer[freeTimer].maxNumRuns   = n;
-  timer[freeTimer].enabled      = true;
-  timer[freeTimer].prev_millis  = elapsed();
+  timer[freeTimer].runsLeft     = n;
+  timer[freeTimer].prev_millis  = now();
+
+#if ISR_TIMER_USE_STATS
+  TimerInterrupt_resetStats(stats[freeTimer]);
+#endif
+
+  // Used last, once the slot is set
+  if (h)
+  {
+    setMaskBits(paramMask, (timer_mask_t) 1 << freeTimer);
+  }
+
+  setMaskBits(enabledMask, (timer_mask_t) 1 << freeTimer);
+  setMaskBits(usedMask, (timer_mask_t) 1 << freeTimer);
 
   numTimers++;
 
+  deadlineValid = false;
+
+  // From the ISR, runTickless() scans again
+  if ( (hwTimer != NULL) && !inRun )
+  {
+    reschedule(u);
+  }
+
   return freeTimer;
 }
 
 
-int ISR_Timer::setTimer(const unsigned long& d, timer_callback f, const unsigned& n)
+template<uint8_t N>
+int ISR_TimerT<N>::setTimer(const unsigned long& d, timer_callback f, const unsigned& n)
 {
   return setupTimer(d, (void *)f, NULL, false, n);
 }
 
-int ISR_Timer::setTimer(const unsigned long& d, timer_callback_p f, void* p, const unsigned& n)
+template<uint8_t N>
+int ISR_TimerT<N>::setTimer(const unsigned long& d, timer_callback_p f, void* p, const unsigned& n)
 {
   return setupTimer(d, (void *)f, p, true, n);
 }
 
-int ISR_Timer::setInterval(const unsigned long& d, timer_callback f)
+template<uint8_t N>
+int ISR_TimerT<N>::setInterval(const unsigned long& d, timer_callback f)
 {
   return setupTimer(d, (void *)f, NULL, false, RUN_FOREVER);
 }
 
-int ISR_Timer::setInterval(const unsigned long& d, timer_callback_p f, void* p)
+template<uint8_t N>
+int ISR_TimerT<N>::setInterval(const unsigned long& d, timer_callback_p f, void* p)
 {
   return setupTimer(d, (void *)f, p, true, RUN_FOREVER);
 }
 
-int ISR_Timer::setTimeout(const unsigned long& d, timer_callback f)
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeout(const unsigned long& d, timer_callback f)
 {
   return setupTimer(d, (void *)f, NULL, false, RUN_ONCE);
 }
 
-int ISR_Timer::setTimeout(const unsigned long& d, timer_callback_p f, void* p)
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeout(const unsigned long& d, timer_callback_p f, void* p)
 {
   return setupTimer(d, (void *)f, p, true, RUN_ONCE);
 }
 
-bool ISR_Timer::changeInterval(const unsigned& numTimer, const unsigned long& d)
+template<uint8_t N>
+int ISR_TimerT<N>::setIntervalUs(const unsigned long& us, timer_callback f)
+{
+  return setupTimer(us, (void *)f, NULL, false, RUN_FOREVER, 1000000UL);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setIntervalUs(const unsigned long& us, timer_callback_p f, void* p)
+{
+  return setupTimer(us, (void *)f, p, true, RUN_FOREVER, 1000000UL);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeoutUs(const unsigned long& us, timer_callback f)
+{
+  return setupTimer(us, (void *)f, NULL, false, RUN_ONCE, 1000000UL);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeoutUs(const unsigned long& us, timer_callback_p f, void* p)
+{
+  return setupTimer(us, (void *)f, p, true, RUN_ONCE, 1000000UL);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setIntervalTicks(const unsigned long& ticks, timer_callback f)
+{
+  return setupTimerUnits(ticks, (void *)f, NULL, false, RUN_FOREVER);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setIntervalTicks(const unsigned long& ticks, timer_callback_p f, void* p)
+{
+  return setupTimerUnits(ticks, (void *)f, p, true, RUN_FOREVER);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeoutTicks(const unsigned long& ticks, timer_callback f)
+{
+  return setupTimerUnits(ticks, (void *)f, NULL, false, RUN_ONCE);
+}
+
+template<uint8_t N>
+int ISR_TimerT<N>::setTimeoutTicks(const unsigned long& ticks, timer_callback_p f, void* p)
+{
+  return setupTimerUnits(ticks, (void *)f, p, true, RUN_ONCE);
+}
+
+template<uint8_t N>
+bool ISR_TimerT<N>::changeInterval(const unsigned& numTimer, const unsigned long& d)
+{
+  unsigned long u;
+
+  return toUnits(d, 1000, u) && changeIntervalUnits(numTimer, u);
+}
+
+template<uint8_t N>
+bool ISR_TimerT<N>::changeIntervalUs(const unsigned& numTimer, const unsigned long& us)
+{
+  unsigned long u;
+
+  return toUnits(us, 1000000UL, u) && changeIntervalUnits(numTimer, u);
+}
+
+template<uint8_t N>
+bool ISR_TimerT<N>::changeIntervalTicks(const unsigned& numTimer, const unsigned long& ticks)
+{
+  return changeIntervalUnits(numTimer, ticks);
+}
+
+template<uint8_t N>
+bool ISR_TimerT<N>::changeIntervalUnits(const unsigned& numTimer, const unsigned long& u)
 {
   if (numTimer >= MAX_TIMERS)
   {
@@ -223,10 +453,24 @@ bool ISR_Timer::changeInterval(const unsigned& numTimer, const unsigned long& d)
   }
 
   // Updates interval of existing specified timer
-  if (timer[numTimer].callback != NULL)
+  if (usedMask & ((timer_mask_t) 1 << numTimer))
   {
-    timer[numTimer].delay = d;
-    timer[numTimer].prev_millis = elapsed();
+    // Not torn by run() in ISR
+    uint8_t sreg = SREG;
+    noInterrupts();
+
+    timer[numTimer].delay = u;
+    timer[numTimer].prev_millis = now();
+
+    SREG = sreg;
+
+    deadlineValid = false;
+
+    if ( (hwTimer != NULL) && !inRun )
+    {
+      reschedule(u);
+    }
+
     return true;
   }
 
@@ -234,7 +478,8 @@ bool ISR_Timer::changeInterval(const unsigned& numTimer, const unsigned long& d)
   return false;
 }
 
-void ISR_Timer::deleteTimer(const unsigned& timerId)
+template<uint8_t N>
+void ISR_TimerT<N>::deleteTimer(const unsigned& timerId)
 {
   if (timerId >= MAX_TIMERS)
   {
@@ -249,10 +494,17 @@ void ISR_Timer::deleteTimer(const unsigned& timerId)
 
   // don't decrease the number of timers if the
   // specified slot is already empty
-  if (timer[timerId].callback != NULL)
+  if (usedMask & ((timer_mask_t) 1 << timerId))
   {
+    clearMaskBits(usedMask, (timer_mask_t) 1 << timerId);
+    clearMaskBits(enabledMask, (timer_mask_t) 1 << timerId);
+    clearMaskBits(dueMask, (timer_mask_t) 1 << timerId);
+    clearMaskBits(paramMask, (timer_mask_t) 1 << timerId);
+    clearMaskBits(ranMask, (timer_mask_t) 1 << timerId);
+    clearMaskBits(deferMask, (timer_mask_t) 1 << timerId);
+
     memset((void*) &timer[timerId], 0, sizeof (timer_t));
-    timer[timerId].prev_millis = elapsed();
+    timer[timerId].prev_millis = now();
 
     // update number of timers
     numTimers--;
@@ -261,87 +513,379 @@ void ISR_Timer::deleteTimer(const unsigned& timerId)
 
 
 // function contributed by code@rowansimms.com
-void ISR_Timer::restartTimer(const unsigned& numTimer)
+template<uint8_t N>
+void ISR_TimerT<N>::restartTimer(const unsigned& numTimer)
 {
   if (numTimer >= MAX_TIMERS)
   {
     return;
   }
 
-  timer[numTimer].prev_millis = elapsed();
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  timer[numTimer].prev_millis = now();
+
+  SREG = sreg;
 }
 
 
-bool ISR_Timer::isEnabled(const unsigned& numTimer)
+template<uint8_t N>
+bool ISR_TimerT<N>::isEnabled(const unsigned& numTimer)
 {
   if (numTimer >= MAX_TIMERS)
   {
     return false;
   }
 
-  return timer[numTimer].enabled;
+  return (enabledMask & ((timer_mask_t) 1 << numTimer)) != 0;
 }
 
 
-void ISR_Timer::enable(const unsigned& numTimer)
+template<uint8_t N>
+void ISR_TimerT<N>::enable(const unsigned& numTimer)
 {
   if (numTimer >= MAX_TIMERS)
   {
     return;
   }
 
-  timer[numTimer].enabled = true;
+  setMaskBits(enabledMask, (timer_mask_t) 1 << numTimer);
 }
 
 
-void ISR_Timer::disable(const unsigned& numTimer)
+template<uint8_t N>
+void ISR_TimerT<N>::disable(const unsigned& numTimer)
 {
   if (numTimer >= MAX_TIMERS)
   {
     return;
   }
 
-  timer[numTimer].enabled = false;
+  clearMaskBits(enabledMask, (timer_mask_t) 1 << numTimer);
 }
 
-void ISR_Timer::enableAll()
+template<uint8_t N>
+void ISR_TimerT<N>::enableAll()
 {
-  // Enable all timers with a callback assigned (used)
-  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+  // Enable all timers with a callback assigned (used), except limited runs timers which already ran
+  setMaskBits(enabledMask, usedMask & ~ranMask);
+}
+
+template<uint8_t N>
+void ISR_TimerT<N>::disableAll()
+{
+  // Disable all timers with a callback assigned (used), except limited runs timers which already ran
+  clearMaskBits(enabledMask, usedMask & ~ranMask);
+}
+
+template<uint8_t N>
+void ISR_TimerT<N>::toggle(const unsigned& numTimer)
+{
+  if (numTimer >= MAX_TIMERS)
   {
-    if (timer[i].callback != NULL && timer[i].numRuns == RUN_FOREVER)
-    {
-      timer[i].enabled = true;
-    }
+    return;
   }
+
+  timer_mask_t bit = (timer_mask_t) 1 << numTimer;
+
+  if (enabledMask & bit)
+    clearMaskBits(enabledMask, bit);
+  else
+    setMaskBits(enabledMask, bit);
 }
 
-void ISR_Timer::disableAll()
+
+template<uint8_t N>
+bool ISR_TimerT<N>::setDeferred(const unsigned& numTimer, const bool& deferred)
 {
-  // Disable all timers with a callback assigned (used)
-  for (uint8_t i = 0; i < MAX_TIMERS; i++)
+  if ( (numTimer >= MAX_TIMERS) || !(usedMask & ((timer_mask_t) 1 << numTimer)) )
   {
-    if (timer[i].callback != NULL && timer[i].numRuns == RUN_FOREVER)
-    {
-      timer[i].enabled = false;
-    }
+    return false;
+  }
+
+  if (!deferred)
+  {
+    clearMaskBits(deferMask, (timer_mask_t) 1 << numTimer);
+
+    return true;
+  }
+
+  if (eventQueue == NULL)
+  {
+    TISR_LOGERROR(F("setDeferred: no event queue"));
+
+    return false;
   }
+
+  setMaskBits(deferMask, (timer_mask_t) 1 << numTimer);
+
+  return true;
+}
+
+
+#if ISR_TIMER_USE_STATS
+template<uint8_t N>
+bool ISR_TimerT<N>::getStats(const unsigned& numTimer, timer_stats_t& timerStats)
+{
+  if (numTimer >= MAX_TIMERS)
+  {
+    return false;
+  }
+
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  timerStats = stats[numTimer];
+
+  SREG = sreg;
+
+  return true;
 }
 
-void ISR_Timer::toggle(const unsigned& numTimer)
+
+template<uint8_t N>
+void ISR_TimerT<N>::resetStats(const unsigned& numTimer)
 {
   if (numTimer >= MAX_TIMERS)
   {
     return;
   }
 
-  timer[numTimer].enabled = !timer[numTimer].enabled;
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  TimerInterrupt_resetStats(stats[numTimer]);
+
+  SREG = sreg;
 }
+#endif
 
 
-unsigned ISR_Timer::getNumTimers()
+template<uint8_t N>
+unsigned ISR_TimerT<N>::getNumTimers()
 {
   return numTimers;
 }
 
+
+template<uint8_t N>
+bool ISR_TimerT<N>::attachTickless(TimerInterrupt& timerInterrupt, const uint8_t& clkSel)
+{
+  // millis() while restarting
+  hwTimer     = NULL;
+  timeStamp   = NULL;
+  unitsPerSecond = 1000;
+
+  init();
+
+  timerInterrupt.setClockSource(clkSel);
+  timerInterrupt.init();
+
+  // runTickless() must be called from the ISR itself
+  timerInterrupt.setEventQueue(NULL);
+
+  // Nothing to run yet : longest period, until a timer is set
+  if (!timerInterrupt.setTicks(MAX_TICKS_PER_PERIOD, ticklessHandler, (uint32_t) (uintptr_t) this))
+  {
+    TISR_LOGERROR(F("attachTickless: can't start timer, check its ISR policy"));
+
+    return false;
+  }
+
+  noInterrupts();
+
+  // Time 0 at start of the period
+  TimerTCB[timerInterrupt.getTimer()]->CNT = 0;
+
+  tickBase    = 0;
+  inRun       = false;
+  unitsPerSecond = TimerInterrupt_clockOf(clkSel);
+  minTicks    = ( ISR_TIMER_TICKLESS_MIN_CYCLES / (F_CPU / TimerInterrupt_clockOf(clkSel)) ) + 1;
+  hwTimer     = &timerInterrupt;
+
+  interrupts();
+
+  TISR_LOGWARN3(F("attachTickless: TCB"), timerInterrupt.getTimer(), F(", ticks/s = "), unitsPerSecond);
+
+  return true;
+}
+
+
+template<uint8_t N>
+bool ISR_TimerT<N>::attachTimeStamp(TimeStamp& timeStampTimer)
+{
+  if (!timeStampTimer.isRunning())
+  {
+    TISR_LOGERROR(F("attachTimeStamp: TimeStamp not started"));
+
+    return false;
+  }
+
+  // The ISR of hwTimer would keep on running the timers
+  if (hwTimer != NULL)
+  {
+    hwTimer->detachInterrupt();
+    hwTimer = NULL;
+  }
+
+  timeStamp       = &timeStampTimer;
+  unitsPerSecond  = timeStampTimer.getClockFrequency();
+
+  init();
+
+  TISR_LOGWARN3(F("attachTimeStamp: TCB"), timeStampTimer.getTimer(), F(", ticks/s = "), unitsPerSecond);
+
+  return true;
+}
+
+
+template<uint8_t N>
+void ISR_TimerT<N>::ticklessHandler(void* isrTimer)
+{
+  ((ISR_TimerT<N>*) isrTimer)->runTickless();
+}
+
+
+template<uint8_t N>
+void ISR_TimerT<N>::runTickless()
+{
+  TCB_t* tcb = TimerTCB[hwTimer->getTimer()];
+
+  // At the compare match ending the period of hwTimer
+  tickBase += hwTimer->get_CCMPValue();
+
+  // No other compare match until reprogrammed below, however long the callbacks : the segment now runs to
+  // 0xFFFF. Its flag, cleared here, then tells if CNT wrapped, see ticklessCount()
+  tcb->CCMP     = MAX_COUNT_16BIT;
+  tcb->INTFLAGS = TCB_CAPT_bm;
+
+  inRun = true;
+
+  // Again if a callback set or changed a timer
+  do
+  {
+    runTime = tickBase + ticklessCount();
+
+    run();
+  } while (!deadlineValid);
+
+  inRun = false;
+
+  uint16_t count = ticklessCount();
+
+  // CNT wrapping within minTicks : wait for it, so that the new CCMP can't be below CNT
+  if (MAX_COUNT_16BIT - count < minTicks)
+  {
+    while ( !(tcb->INTFLAGS & TCB_CAPT_bm) );
+
+    count = ticklessCount();
+  }
+
+  // Next deadline, from tickBase. deadlineBase is the runTime of the run() which set it, tickBase having moved
+  // past it if CNT wrapped since
+  long          start = (long) (deadlineBase - tickBase);
+  unsigned long ticks;
+
+  if (start < 0)
+    ticks = (deadlineDelta > (unsigned long) -start) ? deadlineDelta - (unsigned long) -start : 0;
+  else
+    ticks = (deadlineDelta < MAX_TICKS_PER_PERIOD - start) ? start + deadlineDelta : MAX_TICKS_PER_PERIOD;
+
+  // Deadline passed during the callbacks, or too close to be reprogrammed, is set minTicks from now
+  reloadTickless(ticks, count);
+}
+
+
+template<uint8_t N>
+uint16_t ISR_TimerT<N>::ticklessCount()
+{
+  TCB_t* tcb = TimerTCB[hwTimer->getTimer()];
+
+  uint16_t count = tcb->CNT;
+
+  // Flag checked after CNT : if set, CNT may have wrapped after being read
+  if (tcb->INTFLAGS & TCB_CAPT_bm)
+  {
+    tcb->INTFLAGS = TCB_CAPT_bm;
+    tickBase     += MAX_TICKS_PER_SEGMENT;
+    count         = tcb->CNT;
+  }
+
+  return count;
+}
+
+
+template<uint8_t N>
+void ISR_TimerT<N>::reloadTickless(unsigned long ticks, const uint16_t& count)
+{
+  if (ticks < (unsigned long) count + minTicks)
+    ticks = (unsigned long) count + minTicks;
+
+  // The first segment of the new period must end past CNT : else start with a whole 16-bit segment, the ISR
+  // programming the rest at its end
+  if ( (ticks > MAX_TICKS_PER_SEGMENT) && (count > MAX_COUNT_16BIT / 4) )
+    ticks = MAX_TICKS_PER_SEGMENT;
+
+  hwTimer->reloadTicks(ticks);
+}
+
+
+template<uint8_t N>
+void ISR_TimerT<N>::reschedule(const unsigned long& u)
+{
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  TCB_t* tcb = TimerTCB[hwTimer->getTimer()];
+
+  uint16_t segmentsDone = hwTimer->getSegmentsDone();
+  uint16_t count        = tcb->CNT;
+
+  // Segment end within minTicks : wait for it, so that the new CCMP can't be below CNT
+  if ( !(tcb->INTFLAGS & TCB_CAPT_bm) && ( (long) tcb->CCMP - count < (long) minTicks ) )
+  {
+    while ( !(tcb->INTFLAGS & TCB_CAPT_bm) );
+  }
+
+  bool segmentServed = false;
+
+  if (tcb->INTFLAGS & TCB_CAPT_bm)
+  {
+    // End of the period : the ISR comes right after and scans all timers, as deadlineValid is false
+    if (segmentsDone + 1 >= hwTimer->getSegments())
+    {
+      SREG = sreg;
+
+      return;
+    }
+
+    // End of a middle segment, served here as the new period starts from it. Segments of a split period
+    // are over 32768 ticks, so CNT can't wrap again meanwhile
+    tcb->INTFLAGS = TCB_CAPT_bm;
+    segmentsDone++;
+    segmentServed = true;
+  }
+
+  // CNT runs on, the new period counting from the start of the current segment
+  count = tcb->CNT;
+
+  unsigned long segmentStart  = hwTimer->getSegmentStartTicks(segmentsDone);
+  unsigned long remaining     = hwTimer->get_CCMPValue() - segmentStart;
+  unsigned long ticks         = (u > minTicks) ? u : minTicks;
+
+  // Only if due before the programmed interrupt, or to go on with the period after serving a segment end
+  if ( (ticks < remaining - count) || segmentServed )
+  {
+    tickBase += segmentStart;
+
+    reloadTickless( (ticks < remaining - count) ? count + ticks : remaining, count);
+  }
+
+  SREG = sreg;
+}
+
+// ISR_Timer, for all files of the project
+template class ISR_TimerT<16>;
+
 #endif  // MEGA_AVR_ISR_TIMER_IMPL_H
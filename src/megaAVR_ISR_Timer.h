@@ -32,6 +32,7 @@
 #ifndef MEGA_AVR_ISR_TIMER_H
 #define MEGA_AVR_ISR_TIMER_H
 
+#include "megaAVR_TimerInterrupt.h"
 #include "megaAVR_ISR_Timer.hpp"
 #include "megaAVR_ISR_Timer-Impl.h"
 
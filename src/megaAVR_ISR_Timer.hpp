@@ -32,6 +32,11 @@
 #ifndef MEGA_AVR_ISR_TIMER_HPP
 #define MEGA_AVR_ISR_TIMER_HPP
 
+// TimerInterrupt first, for its board settings and the tickless mode
+#include "megaAVR_TimerInterrupt.hpp"
+#include "megaAVR_TimeStamp.hpp"
+#include "megaAVR_TimerEventQueue.hpp"
+
 #if ( defined(__AVR_ATmega4809__) || defined(ARDUINO_AVR_UNO_WIFI_REV2) || defined(ARDUINO_AVR_NANO_EVERY) || \
       defined(ARDUINO_AVR_ATmega4809) || defined(ARDUINO_AVR_ATmega4808) || defined(ARDUINO_AVR_ATmega3209) || \
       defined(ARDUINO_AVR_ATmega3208) || defined(ARDUINO_AVR_ATmega1609) || defined(ARDUINO_AVR_ATmega1608) || \
@@ -91,23 +96,115 @@
 typedef void (*timer_callback)();
 typedef void (*timer_callback_p)(void *);
 
-class ISR_Timer 
+#ifndef ISR_TIMER_TICKLESS_MIN_CYCLES
+  // Tickless mode : min CPU cycles from reprogramming the TCB to its next compare match, so that it can't be missed.
+  // Must also be over the worst latency from a compare match to the tickless ISR (interrupts disabled, other
+  // ISRs) : the TCB period repeats meanwhile, and a second compare match before the ISR can't be seen.
+  // The ISR may wait up to this for CNT to reach its compare match, instead of programming it too close
+  #define ISR_TIMER_TICKLESS_MIN_CYCLES       1024
+#endif
+
+#ifndef ISR_TIMER_USE_STATS
+  // Latency and duration statistics of each timer, see getStats(). Costs sizeof(timer_stats_t) bytes of SRAM per
+  // timer. Nothing is compiled in if false
+  #define ISR_TIMER_USE_STATS                 false
+#endif
+
+// Slot mask type of ISR_TimerT : uint8_t if Byte (N <= 8), uint16_t if Word (N <= 16), else uint32_t
+template<bool Byte, bool Word> struct ISR_TimerMaskOf
+{
+  typedef uint32_t type;
+};
+
+template<bool Word> struct ISR_TimerMaskOf<true, Word>
+{
+  typedef uint8_t type;
+};
+
+template<> struct ISR_TimerMaskOf<false, true>
 {
+  typedef uint16_t type;
+};
+
+// N : number of timers, up to 32. Each timer takes 14 bytes of SRAM, see ISR_Timer for the usual 16
+template<uint8_t N>
+class ISR_TimerT
+{
+    static_assert( (N >= 1) && (N <= 32), "ISR_TimerT: number of timers must be 1 to 32");
+
   public:
     // maximum number of timers
-    const static int MAX_TIMERS = 16;
+    const static int MAX_TIMERS = N;
 
     // setTimer() constants
     const static int RUN_FOREVER = 0;
     const static int RUN_ONCE = 1;
 
     // constructor
-    ISR_Timer();
+    ISR_TimerT();
 
     void  init();
 
-    // this function must be called inside loop()
-    void  run();
+    // this function must be called inside loop(), or from the ISR of a TimerInterrupt, but not in tickless mode
+    void  run() __attribute__((always_inline))
+    {
+      unsigned long current_millis = now();
+
+      // Idle tick : no timer is due yet. Inlined, so that idle ticks return before the register saves of runTimers()
+      if ( deadlineValid && ((current_millis - deadlineBase) < deadlineDelta) )
+        return;
+
+      runTimers(current_millis);
+    };
+
+    // Tickless mode : the ISR_Timer owns timerInterrupt, and reprograms it to interrupt only at the next deadline of
+    // its timers, instead of run() being called at a fixed rate. Time is then counted in ticks of clkSel
+    // (4us with the default 250KHz TCB_CLKSEL_CLKTCA_gc), delays in ms being converted to ticks, and can
+    // be set in us or ticks with setIntervalUs() / setIntervalTicks(). Clears all timers, so call before setting any.
+    // timerInterrupt must use TIMER_ISR_POLICY_FULL. Returns false if it can't be started
+    bool attachTickless(TimerInterrupt& timerInterrupt, const uint8_t& clkSel = TCB_CLKSEL_CLKTCA_gc);
+
+    bool isTickless()
+    {
+      return (hwTimer != NULL);
+    };
+
+    // Count time in ticks of a started TimeStamp instead of millis(), for sub-ms resolution while run() is still
+    // called from loop() or from a TimerInterrupt ISR. Ends the tickless mode. Clears all timers, so call before
+    // setting any. Returns false if timeStampTimer isn't running
+    bool attachTimeStamp(TimeStamp& timeStampTimer);
+
+    // Current time in the unit of timers : millis(), or ticks in tickless mode or of the attached TimeStamp
+    unsigned long now();
+
+    // Units of now() per second : the TCB clock in tickless mode or of the attached TimeStamp, else 1000
+    unsigned long getUnitsPerSecond()
+    {
+      return unitsPerSecond;
+    };
+
+    // units (of now()) to ms, exact to the ms as the TCB clock may not be a whole number of ticks per ms
+    // (312.5 at 20MHz)
+    unsigned long unitsToMs(const unsigned long& units)
+    {
+      return ( (units / unitsPerSecond) * 1000 ) + ( ( (units % unitsPerSecond) * 1000 ) / unitsPerSecond );
+    };
+
+    // As setInterval(), setTimeout() and changeInterval(), with the delay in us, for sub-ms resolution in tickless
+    // mode or with a TimeStamp. Rounded to the nearest tick. Without either, timers are in ms : -1 (false) if us is
+    // not a whole number of ms
+    int setIntervalUs(const unsigned long& us, timer_callback f);
+    int setIntervalUs(const unsigned long& us, timer_callback_p f, void* p);
+    int setTimeoutUs(const unsigned long& us, timer_callback f);
+    int setTimeoutUs(const unsigned long& us, timer_callback_p f, void* p);
+    bool changeIntervalUs(const unsigned& numTimer, const unsigned long& us);
+
+    // Same, with the delay in ticks of the TCB clock in tickless mode, else in ms
+    int setIntervalTicks(const unsigned long& ticks, timer_callback f);
+    int setIntervalTicks(const unsigned long& ticks, timer_callback_p f, void* p);
+    int setTimeoutTicks(const unsigned long& ticks, timer_callback f);
+    int setTimeoutTicks(const unsigned long& ticks, timer_callback_p f, void* p);
+    bool changeIntervalTicks(const unsigned& numTimer, const unsigned long& ticks);
 
     // Timer will call function 'f' every 'd' milliseconds forever
     // returns the timer number (numTimer) on success or
@@ -167,6 +264,30 @@ class ISR_Timer
     // and vice-versa
     void toggle(const unsigned& numTimer);
 
+    // Deferred timers : run() posts their callback to the event queue, with the timer number as event id, instead of
+    // calling it, and queue.dispatch() calls it later from loop(). For slow callbacks, when run() is called from ISR.
+    // NULL queue to call all timers from run() again
+    void setEventQueue(TimerEventQueue* queue)
+    {
+      eventQueue = queue;
+    };
+
+    // Returns false if numTimer isn't set, or if deferred without an event queue
+    bool setDeferred(const unsigned& numTimer, const bool& deferred = true);
+
+    bool isDeferred(const unsigned& numTimer)
+    {
+      return (numTimer < MAX_TIMERS) && (deferMask & ((timer_mask_t) 1 << numTimer));
+    };
+
+#if ISR_TIMER_USE_STATS
+    // Copy of the statistics of numTimer since it was set or resetStats(), in units of now() : latency from its
+    // deadline to the start of the callback, callback duration, and periods skipped as missed deadlines.
+    // Deferred timers count the post to the event queue. Returns false if numTimer is out of range
+    bool getStats(const unsigned& numTimer, timer_stats_t& timerStats);
+    void resetStats(const unsigned& numTimer);
+#endif
+
     // returns the number of used timers
     unsigned  getNumTimers();
 
@@ -177,37 +298,147 @@ class ISR_Timer
     };
 
   private:
-  
-    // deferred call constants
-    const static int DEFCALL_DONTRUN    = 0;    // don't call the callback function
-    const static int DEFCALL_RUNONLY    = 1;    // call the callback function but don't delete the timer
-    const static int DEFCALL_RUNANDDEL  = 2;    // call the callback function and delete the timer
+
+    // One bit per timer slot, bit i for timer[i]
+    typedef typename ISR_TimerMaskOf<(N <= 8), (N <= 16)>::type   timer_mask_t;
 
     // low level function to initialize and enable a new timer
     // returns the timer number (numTimer) on success or
     // -1 on failure (f == NULL) or no free timers
-    int  setupTimer(const unsigned long& d, void* f, void* p, bool h, const unsigned& n);
+    // d in 1/perSecond s, ms by default
+    int  setupTimer(const unsigned long& d, void* f, void* p, bool h, const unsigned& n,
+                    const unsigned long& perSecond = 1000);
+
+    // as setupTimer(), with delay u in the time unit, ms or ticks
+    int  setupTimerUnits(const unsigned long& u, void* f, void* p, bool h, const unsigned& n);
+
+    // as changeInterval(), with delay u in the time unit
+    bool changeIntervalUnits(const unsigned& numTimer, const unsigned long& u);
+
+    // value in 1/perSecond s to time units in u, rounded to nearest. Returns false on overflow
+    bool toUnits(const unsigned long& value, const unsigned long& perSecond, unsigned long& u);
 
     // find the first available slot
     int  findFirstFreeSlot();
 
-    typedef struct 
+    // 14 bytes on AVR, flags being in the masks below. Not volatile : changed from loop() with interrupts disabled,
+    // or while the usedMask bit of the slot is cleared, so never while run() reads it
+    typedef struct
     {
-      unsigned long prev_millis;        // value returned by the millis() function in the previous run() call
+      unsigned long prev_millis;        // time of the previous due run, or of the setup
+      unsigned long delay;              // delay value
       void* callback;                   // pointer to the callback function
       void* param;                      // function parameter
-      bool hasParam;                 // true if callback takes a parameter
-      unsigned long delay;              // delay value
-      unsigned maxNumRuns;              // number of runs to be executed
-      unsigned numRuns;                 // number of executed runs
-      bool enabled;                  // true if enabled
-      unsigned toBeCalled;              // deferred function call (sort of) - N.B.: only used in run()
+      uint16_t runsLeft;                // number of runs left, 0 for RUN_FOREVER
     } timer_t;
 
-    volatile timer_t timer[MAX_TIMERS];
+    timer_t timer[MAX_TIMERS];
+
+    // Slots with a callback, slots enabled, and slots to be called by the current run(). Loops go over the set
+    // bits only, lowest first, instead of over all MAX_TIMERS slots
+    volatile timer_mask_t usedMask;
+    volatile timer_mask_t enabledMask;
+    volatile timer_mask_t dueMask;
+
+    // Callback takes a parameter
+    volatile timer_mask_t paramMask;
+
+    // Limited runs timers which have already run, left out by enableAll() and disableAll()
+    volatile timer_mask_t ranMask;
+
+    // Timers posted to eventQueue instead of being called by run()
+    volatile timer_mask_t deferMask;
+    TimerEventQueue*      eventQueue;
+
+#if ISR_TIMER_USE_STATS
+    // Written by run() only, once the slot is used
+    timer_stats_t stats[MAX_TIMERS];
+#endif
+
+    // Masks are changed from loop() and from callbacks in ISR, so not with a plain read-modify-write
+    void setMaskBits(volatile timer_mask_t& mask, const timer_mask_t& bits)
+    {
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      mask |= bits;
+
+      SREG = sreg;
+    };
+
+    void clearMaskBits(volatile timer_mask_t& mask, const timer_mask_t& bits)
+    {
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      mask &= ~bits;
+
+      SREG = sreg;
+    };
+
+    // Index of the lowest set bit of a non-zero mask
+    static uint8_t firstSlotOf(const timer_mask_t mask)
+    {
+      return (sizeof(timer_mask_t) > sizeof(unsigned)) ? __builtin_ctzl(mask) : __builtin_ctz(mask);
+    };
 
     // actual number of timers in use (-1 means uninitialized)
-    volatile int numTimers;
+    volatile int8_t numTimers;
+
+    // Earliest deadline found by the last full scan of run() : no timer is due before deadlineDelta ms
+    // after deadlineBase. Until then, run() returns after a single compare
+    unsigned long deadlineBase;
+    unsigned long deadlineDelta;
+
+    // Cleared by any change which may make a timer due earlier, so that the next run() scans all timers
+    volatile bool deadlineValid;
+
+    // Time from the time base, even during runTickless()
+    unsigned long currentTime();
+
+    // Full scan of run() : calls the due timers, and finds the next deadline
+    void runTimers(const unsigned long current_millis) __attribute__((noinline));
+
+    // Tickless mode : hardware timer, or NULL for millis() as time base
+    TimerInterrupt* hwTimer;
+
+    // Time base if not tickless : TimeStamp, or NULL for millis()
+    TimeStamp* timeStamp;
+
+    // 1000 for millis(), or the TCB clock in tickless mode or of timeStamp
+    unsigned long unitsPerSecond;
+
+    // Tickless mode : min ticks to the next compare match, from ISR_TIMER_TICKLESS_MIN_CYCLES
+    uint16_t minTicks;
+
+    // Tickless mode : time at the start of the current period of hwTimer
+    unsigned long tickBase;
+
+    // Tickless mode : true while run() is called from the ISR, with now() returning runTime
+    volatile bool inRun;
+    unsigned long runTime;
+
+    // Tickless mode : callback of hwTimer, with this ISR_TimerT as parameter
+    static void ticklessHandler(void* isrTimer);
+
+    // Tickless mode : run() then program hwTimer for the next deadline. From ISR
+    void runTickless();
+
+    // Tickless mode, from runTickless() : CNT since tickBase. If CNT wrapped at 0xFFFF, moves tickBase on
+    uint16_t ticklessCount();
+
+    // Tickless mode : program hwTimer for a period of ticks from the start of its current segment, CNT being count,
+    // without writing CNT so that no tick is lost. With interrupts disabled
+    void reloadTickless(unsigned long ticks, const uint16_t& count);
+
+    // Tickless mode : bring the next interrupt forward for a timer due u units from now. Not from ISR
+    void reschedule(const unsigned long& u);
 };
 
+// 16 timers, 267 bytes of SRAM
+typedef ISR_TimerT<16>    ISR_Timer;
+
+// Compiled once, in megaAVR_ISR_Timer-Impl.h
+extern template class ISR_TimerT<16>;
+
 #endif  // MEGA_AVR_ISR_TIMER_HPP
@@ -0,0 +1,210 @@
+/****************************************************************************************************************************
+  megaAVR_TimeStamp-Impl.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimeStamp runs a TCB free, its 16-bit counter being extended to 32 bits by counting its overflows in software.
+  now() returns a consistent 32-bit time in ticks of the TCB clock, from loop() or from any ISR, for much less than
+  micros(), with helpers to convert tick counts to us and ns.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMESTAMP_IMPL_H
+#define MEGA_AVR_TIMESTAMP_IMPL_H
+
+#ifndef TIMER_INTERRUPT_DEBUG
+  #define TIMER_INTERRUPT_DEBUG      0
+#endif
+
+bool TimeStamp::begin(const uint8_t& clkSel)
+{
+  if (_tcb == NULL)
+  {
+    TISR_LOGERROR(F("Timer not selected"));
+
+    return false;
+  }
+
+  if ( (clkSel != TCB_CLKSEL_CLKDIV1_gc) && (clkSel != TCB_CLKSEL_CLKDIV2_gc) && (clkSel != TCB_CLKSEL_CLKTCA_gc) )
+  {
+    TISR_LOGERROR1(F("Invalid clock source ="), clkSel);
+
+    return false;
+  }
+
+  uint32_t clock = TimerInterrupt_clockOf(clkSel);
+
+  noInterrupts();
+
+  _tcb->CTRLA   = 0;
+  _tcb->INTCTRL = 0;
+
+  _clkSel     = clkSel;
+  _overflows  = 0;
+
+  _usPerTick  = ( (clock <= 1000000UL) && ( (1000000UL % clock) == 0 ) ) ? (1000000UL / clock) : 0;
+  _ticksPerUs = ( (clock > 1000000UL) && ( (clock % 1000000UL) == 0 ) ) ? (clock / 1000000UL) : 0;
+  _usShift    = ( _ticksPerUs && !( _ticksPerUs & (_ticksPerUs - 1) ) ) ? __builtin_ctz(_ticksPerUs) : 0;
+
+  // Periodic interrupt mode, with the longest period : the counter wraps from 0xFFFF to 0, setting CAPT
+  _tcb->CTRLB     = TCB_CNTMODE_INT_gc;
+  _tcb->EVCTRL    = 0;
+  _tcb->CCMP      = MAX_COUNT_16BIT;
+  _tcb->CNT       = 0;
+  _tcb->INTFLAGS  = TCB_CAPT_bm;
+  _tcb->INTCTRL   = TCB_CAPT_bm;
+  _tcb->CTRLA     = clkSel | TCB_ENABLE_bm;
+
+  interrupts();
+
+  TISR_LOGWARN3(F("TCB"), _timer, F(", timestamp ticks/s ="), clock);
+
+  return true;
+}
+
+void TimeStamp::end()
+{
+  if (_tcb == NULL)
+    return;
+
+  noInterrupts();
+
+  _tcb->CTRLA   = 0;
+  _tcb->INTCTRL = 0;
+
+  // Count a pending overflow, for now() to stay monotonic
+  if (_tcb->INTFLAGS & TCB_CAPT_bm)
+  {
+    _overflows++;
+    _tcb->INTFLAGS = TCB_CAPT_bm;
+  }
+
+  interrupts();
+}
+
+////////////////////////////////////////////////////////
+
+// A TCB is either a TimerInterrupt (USE_TIMER_n), a TimerCapture (USE_CAPTURE_TIMER_n) or a TimeStamp
+// (USE_TIMESTAMP_TIMER_n), as all own ISR(TCBn_INT_vect)
+
+#if !defined(USE_TIMESTAMP_TIMER_0)
+  #define USE_TIMESTAMP_TIMER_0     false
+#endif
+
+#if !defined(USE_TIMESTAMP_TIMER_1)
+  #define USE_TIMESTAMP_TIMER_1     false
+#endif
+
+#if !defined(USE_TIMESTAMP_TIMER_2)
+  #define USE_TIMESTAMP_TIMER_2     false
+#endif
+
+#if !defined(USE_TIMESTAMP_TIMER_3)
+  #define USE_TIMESTAMP_TIMER_3     false
+#endif
+
+//////////////////////////////////////////////
+
+#if USE_TIMESTAMP_TIMER_0
+#if USE_TIMER_0
+  #error TCB0 is used by both USE_TIMER_0 and USE_TIMESTAMP_TIMER_0
+#endif
+
+#if ( defined(USE_CAPTURE_TIMER_0) && USE_CAPTURE_TIMER_0 )
+  #error TCB0 is used by both USE_CAPTURE_TIMER_0 and USE_TIMESTAMP_TIMER_0
+#endif
+
+#ifndef TIMESTAMP_TIMER0_INSTANTIATED
+// To force pre-instatiate only once
+#define TIMESTAMP_TIMER0_INSTANTIATED
+TimeStamp ITimeStamp0(HW_TIMER_0);
+
+ISR(TCB0_INT_vect)
+{
+  ITimeStamp0.handleInterrupt(TCB0);
+}
+#endif  //#ifndef TIMESTAMP_TIMER0_INSTANTIATED
+#endif    //#if USE_TIMESTAMP_TIMER_0
+
+#if USE_TIMESTAMP_TIMER_1
+#if USE_TIMER_1
+  #error TCB1 is used by both USE_TIMER_1 and USE_TIMESTAMP_TIMER_1
+#endif
+
+#if ( defined(USE_CAPTURE_TIMER_1) && USE_CAPTURE_TIMER_1 )
+  #error TCB1 is used by both USE_CAPTURE_TIMER_1 and USE_TIMESTAMP_TIMER_1
+#endif
+
+#ifndef TIMESTAMP_TIMER1_INSTANTIATED
+// To force pre-instatiate only once
+#define TIMESTAMP_TIMER1_INSTANTIATED
+TimeStamp ITimeStamp1(HW_TIMER_1);
+
+ISR(TCB1_INT_vect)
+{
+  ITimeStamp1.handleInterrupt(TCB1);
+}
+#endif  //#ifndef TIMESTAMP_TIMER1_INSTANTIATED
+#endif    //#if USE_TIMESTAMP_TIMER_1
+
+#if USE_TIMESTAMP_TIMER_2
+#if USE_TIMER_2
+  #error TCB2 is used by both USE_TIMER_2 and USE_TIMESTAMP_TIMER_2
+#endif
+
+#if ( defined(USE_CAPTURE_TIMER_2) && USE_CAPTURE_TIMER_2 )
+  #error TCB2 is used by both USE_CAPTURE_TIMER_2 and USE_TIMESTAMP_TIMER_2
+#endif
+
+#ifndef TIMESTAMP_TIMER2_INSTANTIATED
+// To force pre-instatiate only once
+#define TIMESTAMP_TIMER2_INSTANTIATED
+TimeStamp ITimeStamp2(HW_TIMER_2);
+
+ISR(TCB2_INT_vect)
+{
+  ITimeStamp2.handleInterrupt(TCB2);
+}
+#endif  //#ifndef TIMESTAMP_TIMER2_INSTANTIATED
+#endif    //#if USE_TIMESTAMP_TIMER_2
+
+#if USE_TIMESTAMP_TIMER_3
+#if USE_TIMER_3
+  #error TCB3 is used by both USE_TIMER_3 and USE_TIMESTAMP_TIMER_3
+#endif
+
+#if ( defined(USE_CAPTURE_TIMER_3) && USE_CAPTURE_TIMER_3 )
+  #error TCB3 is used by both USE_CAPTURE_TIMER_3 and USE_TIMESTAMP_TIMER_3
+#endif
+
+#ifndef TIMESTAMP_TIMER3_INSTANTIATED
+// To force pre-instatiate only once
+#define TIMESTAMP_TIMER3_INSTANTIATED
+TimeStamp ITimeStamp3(HW_TIMER_3);
+
+ISR(TCB3_INT_vect)
+{
+  ITimeStamp3.handleInterrupt(TCB3);
+}
+#endif  //#ifndef TIMESTAMP_TIMER3_INSTANTIATED
+#endif    //#if USE_TIMESTAMP_TIMER_3
+
+#endif // MEGA_AVR_TIMESTAMP_IMPL_H
@@ -0,0 +1,168 @@
+/****************************************************************************************************************************
+  megaAVR_TimeStamp.hpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimeStamp runs a TCB free, its 16-bit counter being extended to 32 bits by counting its overflows in software.
+  now() returns a consistent 32-bit time in ticks of the TCB clock, from loop() or from any ISR, for much less than
+  micros(), with helpers to convert tick counts to us and ns.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMESTAMP_HPP
+#define MEGA_AVR_TIMESTAMP_HPP
+
+#include "megaAVR_TimerInterrupt.hpp"
+
+class TimeStamp
+{
+  private:
+
+    int8_t            _timer;
+    uint8_t           _clkSel;        // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc
+    TCB_t*            _tcb;
+
+    // High word of now(), incremented by the ISR at each overflow of CNT
+    volatile uint16_t _overflows;
+
+    // Conversion shortcuts, set by begin() from the TCB clock. 0 if not applicable
+    uint8_t           _ticksPerUs;    // TCB clock multiple of 1MHz
+    uint8_t           _usShift;       // _ticksPerUs == (1 << _usShift)
+    uint8_t           _usPerTick;     // TCB clock dividing 1MHz, e.g. 4 for 250KHz
+
+  public:
+
+    explicit TimeStamp(const uint8_t& timerNo)
+    {
+      _timer      = timerNo;
+      _clkSel     = TCB_CLKSEL_CLKDIV1_gc;
+      _tcb        = (timerNo < NUM_HW_TIMERS) ? TimerTCB[timerNo] : NULL;
+      _overflows  = 0;
+      _ticksPerUs = 0;
+      _usShift    = 0;
+      _usPerTick  = 0;
+    };
+
+    // Start counting from 0, in ticks of clkSel : 62.5ns with TCB_CLKSEL_CLKDIV1_gc at 16MHz, wrapping after
+    // 2^32 ticks (268s). Interrupts must not be disabled for more than 65536 ticks (4ms), or overflows are lost
+    bool begin(const uint8_t& clkSel = TCB_CLKSEL_CLKDIV1_gc);
+
+    // Stop the TCB. now() keeps returning the time at which it was stopped
+    void end();
+
+    bool isRunning()
+    {
+      return (_tcb != NULL) && (_tcb->CTRLA & TCB_ENABLE_bm);
+    }
+
+    // Time in ticks of the TCB clock. Safe from loop() and from any ISR, including with interrupts disabled, as an
+    // overflow pending since the last ISR is accounted for. Only valid after begin()
+    __attribute__((always_inline)) uint32_t now()
+    {
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      uint16_t high = _overflows;
+      uint16_t low  = _tcb->CNT;
+
+      // Overflow not yet counted by the ISR. If CNT was read just before it, low is near 0xFFFF and high is right
+      if ( (_tcb->INTFLAGS & TCB_CAPT_bm) && !(low & 0x8000) )
+        high++;
+
+      SREG = sreg;
+
+      return ( (uint32_t) high << 16 ) | low;
+    }
+
+    // Ticks since start, a previous now(). Valid across the wrap of now()
+    __attribute__((always_inline)) uint32_t elapsed(const uint32_t& start)
+    {
+      return now() - start;
+    }
+
+    // Conversions, rounded down. Cheapest for a TCB clock of 2^n MHz (shift), then n MHz (32-bit division)
+    // and 1MHz / n (multiplication), other clocks using 64-bit arithmetic. Results must fit in 32 bits :
+    // up to 71min for ticksToUs(), 4.29s for ticksToNs()
+    uint32_t ticksToUs(const uint32_t& ticks)
+    {
+      if (_usShift)
+        return ticks >> _usShift;
+
+      if (_ticksPerUs)
+        return ticks / _ticksPerUs;
+
+      if (_usPerTick)
+        return ticks * _usPerTick;
+
+      return (uint32_t) ( ( (uint64_t) ticks * 1000000UL ) / getClockFrequency() );
+    }
+
+    uint32_t ticksToNs(const uint32_t& ticks)
+    {
+      if (_usShift)
+        return ( (ticks >> _usShift) * 1000UL ) + ( ( (ticks & ( (1 << _usShift) - 1 ) ) * 1000UL ) >> _usShift );
+
+      if (_ticksPerUs)
+        return ( (ticks / _ticksPerUs) * 1000UL ) + ( ( (ticks % _ticksPerUs) * 1000UL ) / _ticksPerUs );
+
+      if (_usPerTick)
+        return ticks * _usPerTick * 1000UL;
+
+      return (uint32_t) ( ( (uint64_t) ticks * 1000000000UL ) / getClockFrequency() );
+    }
+
+    uint32_t usToTicks(const uint32_t& us)
+    {
+      if (_ticksPerUs)
+        return us * _ticksPerUs;
+
+      if (_usPerTick)
+        return us / _usPerTick;
+
+      return (uint32_t) ( ( (uint64_t) us * getClockFrequency() ) / 1000000UL );
+    }
+
+    uint8_t getClockSource()
+    {
+      return _clkSel;
+    }
+
+    // Ticks of now() per second
+    uint32_t getClockFrequency()
+    {
+      return TimerInterrupt_clockOf(_clkSel);
+    }
+
+    int8_t getTimer() __attribute__((always_inline))
+    {
+      return _timer;
+    };
+
+    // Called from ISR(TCBn_INT_vect) only
+    __attribute__((always_inline)) void handleInterrupt(TCB_t& tcb)
+    {
+      _overflows++;
+
+      tcb.INTFLAGS = TCB_CAPT_bm;
+    }
+}; // class TimeStamp
+
+#endif      // MEGA_AVR_TIMESTAMP_HPP
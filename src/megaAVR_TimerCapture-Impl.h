@@ -0,0 +1,228 @@
+/****************************************************************************************************************************
+  megaAVR_TimerCapture-Impl.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerCapture uses a TCB in Input Capture Frequency / Pulse-Width Measurement mode, with the input from the Event System.
+  Period and pulse width are captured by hardware at TCB clock resolution, without any pin-change interrupt,
+  and handed to the application through a latest-value and a ring buffer, both readable without disabling interrupts.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMERCAPTURE_IMPL_H
+#define MEGA_AVR_TIMERCAPTURE_IMPL_H
+
+#ifndef TIMER_INTERRUPT_DEBUG
+  #define TIMER_INTERRUPT_DEBUG      0
+#endif
+
+bool TimerCapture::begin(const uint8_t& mode, const uint8_t& channel, const uint8_t& generator,
+                         const uint8_t& clkSel, const bool& invertEdge, const bool& noiseFilter)
+{
+  if ( (_timer < 0) || (_timer >= NUM_HW_TIMERS) )
+  {
+    TISR_LOGERROR(F("Timer not selected"));
+
+    return false;
+  }
+
+  if ( (mode != TCB_CNTMODE_FRQ_gc) && (mode != TCB_CNTMODE_PW_gc) && (mode != TCB_CNTMODE_FRQPW_gc) )
+  {
+    TISR_LOGERROR1(F("Invalid capture mode ="), mode);
+
+    return false;
+  }
+
+  if ( (clkSel != TCB_CLKSEL_CLKDIV1_gc) && (clkSel != TCB_CLKSEL_CLKDIV2_gc) && (clkSel != TCB_CLKSEL_CLKTCA_gc) )
+  {
+    TISR_LOGERROR1(F("Invalid clock source ="), clkSel);
+
+    return false;
+  }
+
+  if (channel >= NUM_EVSYS_CHANNELS)
+  {
+    TISR_LOGERROR1(F("Invalid EVSYS channel ="), channel);
+
+    return false;
+  }
+
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
+
+  tcb->CTRLA    = 0;
+  tcb->INTCTRL  = 0;
+
+  _mode       = mode;
+  _clkSel     = clkSel;
+  _period     = 0;
+  _pulseWidth = 0;
+  _sequence   = 0;
+  _head       = 0;
+  _tail       = 0;
+  _overruns   = 0;
+
+  TimerInterrupt_setEventGenerator(channel, generator);
+  TimerInterrupt_setTimerEventUser(_timer, channel);
+
+  tcb->CTRLB    = mode;
+  tcb->EVCTRL   = TCB_CAPTEI_bm | (invertEdge ? TCB_EDGE_bm : 0) | (noiseFilter ? TCB_FILTER_bm : 0);
+  tcb->CNT      = 0;
+  tcb->INTFLAGS = TCB_CAPT_bm;
+  tcb->INTCTRL  = TCB_CAPT_bm;
+  tcb->CTRLA    = clkSel | TCB_ENABLE_bm;
+
+  interrupts();
+
+  TISR_LOGWARN3(F("TCB"), _timer, F(", capture mode ="), mode);
+  TISR_LOGWARN3(F("EVSYS channel ="), channel, F(", generator ="), generator);
+
+  return true;
+}
+
+void TimerCapture::end()
+{
+  if ( (_timer < 0) || (_timer >= NUM_HW_TIMERS) )
+    return;
+
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
+
+  tcb->CTRLA    = 0;
+  tcb->INTCTRL  = 0;
+  tcb->EVCTRL   = 0;
+  tcb->INTFLAGS = TCB_CAPT_bm;
+
+  TimerInterrupt_clearTimerEventUser(_timer);
+
+  interrupts();
+}
+
+////////////////////////////////////////////////////////
+
+// A TCB is either a TimerInterrupt (USE_TIMER_n), a TimerCapture (USE_CAPTURE_TIMER_n) or a TimeStamp
+// (USE_TIMESTAMP_TIMER_n), as all own ISR(TCBn_INT_vect)
+
+#if !defined(USE_CAPTURE_TIMER_0)
+  #define USE_CAPTURE_TIMER_0     false
+#endif
+
+#if !defined(USE_CAPTURE_TIMER_1)
+  #define USE_CAPTURE_TIMER_1     false
+#endif
+
+#if !defined(USE_CAPTURE_TIMER_2)
+  #define USE_CAPTURE_TIMER_2     false
+#endif
+
+#if !defined(USE_CAPTURE_TIMER_3)
+  #define USE_CAPTURE_TIMER_3     false
+#endif
+
+//////////////////////////////////////////////
+
+#if USE_CAPTURE_TIMER_0
+#if USE_TIMER_0
+  #error TCB0 is used by both USE_TIMER_0 and USE_CAPTURE_TIMER_0
+#endif
+
+#if ( defined(USE_TIMESTAMP_TIMER_0) && USE_TIMESTAMP_TIMER_0 )
+  #error TCB0 is used by both USE_TIMESTAMP_TIMER_0 and USE_CAPTURE_TIMER_0
+#endif
+
+#ifndef CAPTURE_TIMER0_INSTANTIATED
+// To force pre-instatiate only once
+#define CAPTURE_TIMER0_INSTANTIATED
+TimerCapture ICapture0(HW_TIMER_0);
+
+ISR(TCB0_INT_vect)
+{
+  ICapture0.handleInterrupt(TCB0);
+}
+#endif  //#ifndef CAPTURE_TIMER0_INSTANTIATED
+#endif    //#if USE_CAPTURE_TIMER_0
+
+#if USE_CAPTURE_TIMER_1
+#if USE_TIMER_1
+  #error TCB1 is used by both USE_TIMER_1 and USE_CAPTURE_TIMER_1
+#endif
+
+#if ( defined(USE_TIMESTAMP_TIMER_1) && USE_TIMESTAMP_TIMER_1 )
+  #error TCB1 is used by both USE_TIMESTAMP_TIMER_1 and USE_CAPTURE_TIMER_1
+#endif
+
+#ifndef CAPTURE_TIMER1_INSTANTIATED
+// To force pre-instatiate only once
+#define CAPTURE_TIMER1_INSTANTIATED
+TimerCapture ICapture1(HW_TIMER_1);
+
+ISR(TCB1_INT_vect)
+{
+  ICapture1.handleInterrupt(TCB1);
+}
+#endif  //#ifndef CAPTURE_TIMER1_INSTANTIATED
+#endif    //#if USE_CAPTURE_TIMER_1
+
+#if USE_CAPTURE_TIMER_2
+#if USE_TIMER_2
+  #error TCB2 is used by both USE_TIMER_2 and USE_CAPTURE_TIMER_2
+#endif
+
+#if ( defined(USE_TIMESTAMP_TIMER_2) && USE_TIMESTAMP_TIMER_2 )
+  #error TCB2 is used by both USE_TIMESTAMP_TIMER_2 and USE_CAPTURE_TIMER_2
+#endif
+
+#ifndef CAPTURE_TIMER2_INSTANTIATED
+// To force pre-instatiate only once
+#define CAPTURE_TIMER2_INSTANTIATED
+TimerCapture ICapture2(HW_TIMER_2);
+
+ISR(TCB2_INT_vect)
+{
+  ICapture2.handleInterrupt(TCB2);
+}
+#endif  //#ifndef CAPTURE_TIMER2_INSTANTIATED
+#endif    //#if USE_CAPTURE_TIMER_2
+
+#if USE_CAPTURE_TIMER_3
+#if USE_TIMER_3
+  #error TCB3 is used by both USE_TIMER_3 and USE_CAPTURE_TIMER_3
+#endif
+
+#if ( defined(USE_TIMESTAMP_TIMER_3) && USE_TIMESTAMP_TIMER_3 )
+  #error TCB3 is used by both USE_TIMESTAMP_TIMER_3 and USE_CAPTURE_TIMER_3
+#endif
+
+#ifndef CAPTURE_TIMER3_INSTANTIATED
+// To force pre-instatiate only once
+#define CAPTURE_TIMER3_INSTANTIATED
+TimerCapture ICapture3(HW_TIMER_3);
+
+ISR(TCB3_INT_vect)
+{
+  ICapture3.handleInterrupt(TCB3);
+}
+#endif  //#ifndef CAPTURE_TIMER3_INSTANTIATED
+#endif    //#if USE_CAPTURE_TIMER_3
+
+#endif // MEGA_AVR_TIMERCAPTURE_IMPL_H
@@ -0,0 +1,220 @@
+/****************************************************************************************************************************
+  megaAVR_TimerCapture.hpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerCapture uses a TCB in Input Capture Frequency / Pulse-Width Measurement mode, with the input from the Event System.
+  Period and pulse width are captured by hardware at TCB clock resolution, without any pin-change interrupt,
+  and handed to the application through a latest-value and a ring buffer, both readable without disabling interrupts.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMERCAPTURE_HPP
+#define MEGA_AVR_TIMERCAPTURE_HPP
+
+#include "megaAVR_TimerInterrupt.hpp"
+
+#ifndef TIMER_CAPTURE_BUFFER_SIZE
+  // Ring size for read(), holding up to TIMER_CAPTURE_BUFFER_SIZE - 1 captures. Must be a power of 2, up to 128
+  #define TIMER_CAPTURE_BUFFER_SIZE     8
+#endif
+
+#if ( (TIMER_CAPTURE_BUFFER_SIZE < 2) || (TIMER_CAPTURE_BUFFER_SIZE > 128) || \
+      (TIMER_CAPTURE_BUFFER_SIZE & (TIMER_CAPTURE_BUFFER_SIZE - 1)) )
+  #error TIMER_CAPTURE_BUFFER_SIZE must be a power of 2, from 2 to 128
+#endif
+
+// One measurement, in ticks of the TCB clock (see TimerCapture::getClockFrequency()).
+// pulseWidth is 0 in TCB_CNTMODE_FRQ_gc mode, period is 0 in TCB_CNTMODE_PW_gc mode
+typedef struct
+{
+  uint16_t period;
+  uint16_t pulseWidth;
+} capture_t;
+
+class TimerCapture
+{
+  private:
+
+    int8_t            _timer;
+    uint8_t           _mode;          // TCB_CNTMODE_FRQ_gc, TCB_CNTMODE_PW_gc or TCB_CNTMODE_FRQPW_gc
+    uint8_t           _clkSel;        // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc
+
+    // Latest capture, written by the ISR only. _sequence is incremented after each capture, skipping 0
+    volatile uint16_t _period;
+    volatile uint16_t _pulseWidth;
+    volatile uint8_t  _sequence;
+
+    // Single-producer (ISR), single-consumer (read()) ring. _head is written by the ISR only, _tail by read() only
+    volatile uint16_t _periods[ TIMER_CAPTURE_BUFFER_SIZE ];
+    volatile uint16_t _pulseWidths[ TIMER_CAPTURE_BUFFER_SIZE ];
+    volatile uint8_t  _head;
+    volatile uint8_t  _tail;
+
+    volatile uint16_t _overruns;      // captures not queued because the ring was full
+
+  public:
+
+    explicit TimerCapture(const uint8_t& timerNo)
+    {
+      _timer      = timerNo;
+      _mode       = TCB_CNTMODE_FRQPW_gc;
+      _clkSel     = TCB_CLKSEL_CLKTCA_gc;
+      _period     = 0;
+      _pulseWidth = 0;
+      _sequence   = 0;
+      _head       = 0;
+      _tail       = 0;
+      _overruns   = 0;
+    };
+
+    // mode : TCB_CNTMODE_FRQ_gc (period), TCB_CNTMODE_PW_gc (pulse width) or TCB_CNTMODE_FRQPW_gc (both).
+    // The input is routed from generator (e.g. EVSYS_GENERATOR_PORT0_PIN2_gc) through EVSYS channel to the TCB.
+    // Measurements start on the rising edge, or on the falling edge if invertEdge.
+    // Periods longer than 65536 ticks of clkSel are not detected and wrap around
+    bool begin(const uint8_t& mode, const uint8_t& channel, const uint8_t& generator,
+               const uint8_t& clkSel = TCB_CLKSEL_CLKTCA_gc, const bool& invertEdge = false, const bool& noiseFilter = false);
+
+    // Stop capturing and disconnect the TCB from its EVSYS channel
+    void end();
+
+    // Copy the latest capture. Return its sequence number (1-255, wrapping), which changes with each capture,
+    // or 0 if there is no capture yet
+    uint8_t getLatest(capture_t& capture)
+    {
+      uint8_t sequence;
+
+      // Retry if a capture interrupt updated the latest value while it was being copied
+      do
+      {
+        sequence            = _sequence;
+        capture.period      = _period;
+        capture.pulseWidth  = _pulseWidth;
+      } while (sequence != _sequence);
+
+      return sequence;
+    }
+
+    // Number of captures queued for read()
+    uint8_t available()
+    {
+      return (uint8_t) (_head - _tail) & (TIMER_CAPTURE_BUFFER_SIZE - 1);
+    }
+
+    // Dequeue the oldest capture. Return false if none is queued
+    bool read(capture_t& capture)
+    {
+      uint8_t tail = _tail;
+
+      if (tail == _head)
+        return false;
+
+      capture.period      = _periods[tail];
+      capture.pulseWidth  = _pulseWidths[tail];
+
+      _tail = (tail + 1) & (TIMER_CAPTURE_BUFFER_SIZE - 1);
+
+      return true;
+    }
+
+    // Number of captures dropped because the ring was full
+    uint16_t getOverruns()
+    {
+      uint16_t overruns;
+
+      do
+      {
+        overruns = _overruns;
+      } while (overruns != _overruns);
+
+      return overruns;
+    }
+
+    uint8_t getMode()
+    {
+      return _mode;
+    }
+
+    uint8_t getClockSource()
+    {
+      return _clkSel;
+    }
+
+    // Frequency (in Hz) of the ticks of capture_t
+    uint32_t getClockFrequency()
+    {
+      return TimerInterrupt_clockOf(_clkSel);
+    }
+
+    int8_t getTimer() __attribute__((always_inline))
+    {
+      return _timer;
+    };
+
+    // Called from ISR(TCBn_INT_vect) only
+    __attribute__((always_inline)) void handleInterrupt(TCB_t& tcb)
+    {
+      uint16_t period;
+      uint16_t pulseWidth;
+
+      if (_mode == TCB_CNTMODE_FRQPW_gc)
+      {
+        // CNT must be read before CCMP, as reading CCMP restarts the measurement
+        period      = tcb.CNT;
+        pulseWidth  = tcb.CCMP;
+      }
+      else if (_mode == TCB_CNTMODE_FRQ_gc)
+      {
+        period      = tcb.CCMP;
+        pulseWidth  = 0;
+      }
+      else
+      {
+        period      = 0;
+        pulseWidth  = tcb.CCMP;
+      }
+
+      _period     = period;
+      _pulseWidth = pulseWidth;
+
+      if (++_sequence == 0)
+        _sequence = 1;
+
+      uint8_t head = _head;
+      uint8_t next = (head + 1) & (TIMER_CAPTURE_BUFFER_SIZE - 1);
+
+      if (next == _tail)
+      {
+        _overruns++;
+      }
+      else
+      {
+        _periods[head]      = period;
+        _pulseWidths[head]  = pulseWidth;
+        _head               = next;
+      }
+
+      // Already cleared by reading CCMP, kept for clarity
+      tcb.INTFLAGS = TCB_CAPT_bm;
+    }
+}; // class TimerCapture
+
+#endif      // MEGA_AVR_TIMERCAPTURE_HPP
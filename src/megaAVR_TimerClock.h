@@ -0,0 +1,141 @@
+/****************************************************************************************************************************
+  megaAVR_TimerClock.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TCB clock selection and period math of TimerInterrupt : ticks for a frequency, clock selection and split of
+  a period into 16-bit segments. Only needs stdint.h, so that host tools such as extras/TimerPlanner compute
+  exactly what the library does. Clocks are given by index, 0 to NUM_TCB_CLOCKS - 1 : CLK_PER, CLK_PER / 2,
+  and the TCA clock (CLK_PER / 64, as configured by the core).
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMERCLOCK_H
+#define MEGA_AVR_TIMERCLOCK_H
+
+#include <stdint.h>
+
+#define MAX_COUNT_16BIT           65535UL
+
+// A period longer than MAX_TICKS_PER_SEGMENT is split into up to 65535 equal segments, one interrupt each
+#define MAX_TICKS_PER_SEGMENT     ( MAX_COUNT_16BIT + 1 )
+#define MAX_TICKS_PER_PERIOD      ( MAX_COUNT_16BIT * MAX_TICKS_PER_SEGMENT )
+
+// TCB clock sources selectable per timer : TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc and TCB_CLKSEL_CLKTCA_gc
+#define NUM_TCB_CLOCKS            3
+
+// For TimerInterrupt_selectClockIndex(), no clock forced
+#define TIMER_CLOCK_AUTO          -1
+
+// Divider of CLK_PER for clock index, fastest clock first
+constexpr uint32_t TimerInterrupt_dividerOf(const uint8_t clock)
+{
+  return (clock == 0) ? 1 : ( (clock == 1) ? 2 : 64 );
+}
+
+// Ticks of clockFrequency (in Hz) for one period of frequency (in Hz), truncated as by setFrequency().
+// 0 if out of range
+inline uint32_t TimerInterrupt_frequencyToTicks(const uint32_t& clockFrequency, const float& frequency)
+{
+  float ticks = clockFrequency / frequency;
+
+  return (ticks <= (float) MAX_TICKS_PER_PERIOD) ? (uint32_t) ticks : 0;
+}
+
+// Number of segments, i.e. interrupts, for a period of ticks. Up to 65535 if ticks <= MAX_TICKS_PER_PERIOD
+inline uint32_t TimerInterrupt_segmentsOf(const uint32_t& ticks)
+{
+  return ( (ticks - 1) / MAX_TICKS_PER_SEGMENT ) + 1;
+}
+
+// CCMP of a segment, i.e. its length - 1, for a period of ticks split into segments. The first ticks % segments
+// segments are one tick longer
+inline uint16_t TimerInterrupt_segmentCCMPOf(const uint32_t& ticks, const uint16_t& segments)
+{
+  return (ticks / segments) - 1;
+}
+
+// Index of the clock giving the fewest segments (interrupts per period) within maxErrorPPM, the faster clock on a tie.
+// ticksPerClock[] holds the ticks for each of the NUM_TCB_CLOCKS clocks, 0 if out of range. As ticks are truncated,
+// the error is bounded by one tick, i.e. 1000000 / ticks ppm. If no clock is within maxErrorPPM, the fastest one
+// in range. forcedClock is the only clock allowed, or TIMER_CLOCK_AUTO. Return -1 if out of range
+inline int8_t TimerInterrupt_selectClockIndex(const uint32_t ticksPerClock[], const int8_t& forcedClock,
+                                              const uint32_t& maxErrorPPM)
+{
+  int8_t   selected       = -1;
+  int8_t   fastestInRange = -1;
+  uint32_t selectedChunks = 0;
+
+  for (int8_t i = 0; i < NUM_TCB_CLOCKS; i++)
+  {
+    uint32_t ticks = ticksPerClock[i];
+
+    if (ticks == 0)
+      continue;
+
+    if (forcedClock != TIMER_CLOCK_AUTO)
+    {
+      if (i == forcedClock)
+        return i;
+
+      continue;
+    }
+
+    if (fastestInRange < 0)
+      fastestInRange = i;
+
+    uint32_t chunks = TimerInterrupt_segmentsOf(ticks);
+
+    if ( (ticks >= 1000000UL / maxErrorPPM) && ( (selected < 0) || (chunks < selectedChunks) ) )
+    {
+      selected        = i;
+      selectedChunks  = chunks;
+    }
+  }
+
+  return (selected < 0) ? fastestInRange : selected;
+}
+
+////////////////////////////////////////////////////////
+
+// Compile-time counterparts, for TimerInterruptFixed
+
+// Nearest number of ticks of clock for frequency (hz / div)
+constexpr uint64_t TimerInterrupt_ticksOf(const uint32_t clock, const uint32_t hz, const uint32_t div)
+{
+  return ( ( (uint64_t) clock * div * 2 ) + hz ) / ( (uint64_t) hz * 2 );
+}
+
+// Number of segments, i.e. interrupts per period
+constexpr uint64_t TimerInterrupt_chunksOf(const uint64_t ticks)
+{
+  return ( ticks + MAX_TICKS_PER_SEGMENT - 1 ) / MAX_TICKS_PER_SEGMENT;
+}
+
+// Error (in ppm) of ticks against the exact value clock * div / hz
+constexpr uint64_t TimerInterrupt_errorPPMOf(const uint64_t ticks, const uint32_t clock, const uint32_t hz,
+                                             const uint32_t div)
+{
+  return ( ( ( ticks * hz > (uint64_t) clock * div ) ? ( ticks * hz - (uint64_t) clock * div ) :
+             ( (uint64_t) clock * div - ticks * hz ) ) * 1000000ULL ) / ( (uint64_t) clock * div );
+}
+
+#endif    // MEGA_AVR_TIMERCLOCK_H
@@ -0,0 +1,35 @@
+/****************************************************************************************************************************
+  megaAVR_TimerEventQueue.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerEventQueue defers timer callbacks from ISR to loop() : an ISR only posts the callback, as an event stamped with
+  its id and time, into a fixed-size ring, and dispatch() called in loop() runs the queued callbacks, so that a slow
+  callback doesn't delay the other timers and interrupts. Depth, high-water mark and dropped events help sizing it.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+
+#ifndef MEGA_AVR_TIMEREVENTQUEUE_H
+#define MEGA_AVR_TIMEREVENTQUEUE_H
+
+#include "megaAVR_TimerEventQueue.hpp"
+#include "megaAVR_TimerEventQueue-Impl.h"
+
+#endif      //#ifndef MEGA_AVR_TIMEREVENTQUEUE_H
@@ -0,0 +1,237 @@
+/****************************************************************************************************************************
+  megaAVR_TimerEventQueue.hpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerEventQueue defers timer callbacks from ISR to loop() : an ISR only posts the callback, as an event stamped with
+  its id and time, into a fixed-size ring, and dispatch() called in loop() runs the queued callbacks, so that a slow
+  callback doesn't delay the other timers and interrupts. Depth, high-water mark and dropped events help sizing it.
+  Posted by ISR_Timer::run() for its deferred timers, and by the ISR of a TimerInterrupt given setEventQueue().
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMEREVENTQUEUE_HPP
+#define MEGA_AVR_TIMEREVENTQUEUE_HPP
+
+#include "megaAVR_TimerInterrupt.hpp"
+#include "megaAVR_TimeStamp.hpp"
+
+// Flag in timer_event_t::id : callback is a timer_callback_p, called with param
+#define TIMER_EVENT_WITH_PARAM      0x80
+
+// Flag in event ids posted by TimerInterrupt : id is TIMER_EVENT_HW_TIMER | timer number (0-3), apart from the
+// slots (0-31) posted by ISR_Timer
+#define TIMER_EVENT_HW_TIMER        0x40
+
+// One deferred callback, 9 bytes. The callback itself is queued, not looked up by id at dispatch(), so that a timer
+// deleted or reused meanwhile can't call the wrong function
+typedef struct
+{
+  void*     callback;
+  void*     param;
+  uint32_t  time;       // of post(), in ticks of the attached TimeStamp, else in us
+  uint8_t   id;         // of the source timer, 0-127 (see getEventId()), with TIMER_EVENT_WITH_PARAM
+} timer_event_t;
+
+// Ring of events, of any size, filled by post() from ISRs and emptied by dispatch() in loop().
+// Declare a TimerEventQueueT<SIZE>, which holds the events
+class TimerEventQueue
+{
+  private:
+
+    volatile timer_event_t* _events;
+    uint8_t                 _mask;          // size - 1
+
+    // _head is written by post() only, _tail by dispatch() only
+    volatile uint8_t        _head;
+    volatile uint8_t        _tail;
+
+    volatile uint8_t        _highWater;     // max depth since resetStats()
+    volatile uint16_t       _dropped;       // events not queued because the ring was full, up to 0xFFFF
+
+    TimeStamp*              _timeStamp;
+
+    // Event being run by dispatch()
+    uint32_t                _eventTime;
+    uint8_t                 _eventId;
+
+    __attribute__((always_inline)) bool push(void* f, void* p, const uint8_t& id)
+    {
+      uint32_t time = (_timeStamp != NULL) ? _timeStamp->now() : micros();
+
+      // Already disabled in ISR, but post() may also be called from loop()
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      uint8_t head  = _head;
+      uint8_t next  = (head + 1) & _mask;
+      bool    queued = (next != _tail);
+
+      if (queued)
+      {
+        volatile timer_event_t& event = _events[head];
+
+        event.callback  = f;
+        event.param     = p;
+        event.time      = time;
+        event.id        = id;
+
+        _head = next;
+
+        uint8_t depth = (next - _tail) & _mask;
+
+        if (depth > _highWater)
+          _highWater = depth;
+      }
+      else if (_dropped != 0xFFFF)
+      {
+        _dropped++;
+      }
+
+      SREG = sreg;
+
+      return queued;
+    }
+
+  protected:
+
+    TimerEventQueue(volatile timer_event_t* events, const uint8_t& size)
+    {
+      _events     = events;
+      _mask       = size - 1;
+      _head       = 0;
+      _tail       = 0;
+      _highWater  = 0;
+      _dropped    = 0;
+      _timeStamp  = NULL;
+      _eventTime  = 0;
+      _eventId    = 0;
+    };
+
+  public:
+
+    // Stamp events with the ticks of timeStamp instead of micros(), much cheaper in ISR
+    void attachTimeStamp(TimeStamp& timeStamp)
+    {
+      _timeStamp = &timeStamp;
+    }
+
+    // Queue f, to be called by dispatch(), with id (0-127) returned by getEventId() meanwhile. From ISR, or loop().
+    // Returns false, the event being counted as dropped, if the queue is full
+    bool post(timer_callback f, const uint8_t& id = 0)
+    {
+      return push((void*) f, NULL, id & ~TIMER_EVENT_WITH_PARAM);
+    }
+
+    bool post(timer_callback_p f, void* p, const uint8_t& id = 0)
+    {
+      return push((void*) f, p, id | TIMER_EVENT_WITH_PARAM);
+    }
+
+    // Run the queued callbacks, oldest first, up to maxEvents if not 0. From loop() only.
+    // Returns the number of callbacks run
+    uint8_t dispatch(const uint8_t& maxEvents = 0);
+
+    // Drop all queued events. From loop() only
+    void clear()
+    {
+      _tail = _head;
+    }
+
+    // Id and time of post() of the event whose callback is being run by dispatch(). Ids posted by the library :
+    // ISR_Timer slot 0-31 for a deferred ISR_Timer timer, TIMER_EVENT_HW_TIMER | 0-3 for a TimerInterrupt given
+    // setEventQueue(), so that timers of both kinds can share a queue. Ids given to post() from sketches are 0-127,
+    // best kept off these two ranges
+    uint8_t getEventId()
+    {
+      return _eventId & ~TIMER_EVENT_WITH_PARAM;
+    }
+
+    uint32_t getEventTime()
+    {
+      return _eventTime;
+    }
+
+    // Time from post() to now, for the event whose callback is being run by dispatch()
+    uint32_t getEventDelay()
+    {
+      return ( (_timeStamp != NULL) ? _timeStamp->now() : micros() ) - _eventTime;
+    }
+
+    // Units of getEventTime() per second
+    uint32_t getUnitsPerSecond()
+    {
+      return (_timeStamp != NULL) ? _timeStamp->getClockFrequency() : 1000000UL;
+    }
+
+    // Number of events queued for dispatch()
+    uint8_t getDepth()
+    {
+      return (uint8_t) (_head - _tail) & _mask;
+    }
+
+    // Max number of events queued at once
+    uint8_t getCapacity()
+    {
+      return _mask;
+    }
+
+    // Max depth reached since resetStats(). Equal to getCapacity() if events may have been dropped
+    uint8_t getHighWaterMark()
+    {
+      return _highWater;
+    }
+
+    // Number of events dropped since resetStats() because the queue was full
+    uint16_t getDropped()
+    {
+      uint16_t dropped;
+
+      do
+      {
+        dropped = _dropped;
+      } while (dropped != _dropped);
+
+      return dropped;
+    }
+
+    void resetStats();
+}; // class TimerEventQueue
+
+// TimerEventQueue of SIZE - 1 events, SIZE a power of 2 up to 128
+template<uint8_t SIZE>
+class TimerEventQueueT : public TimerEventQueue
+{
+    static_assert( (SIZE >= 2) && (SIZE <= 128) && !(SIZE & (SIZE - 1)),
+                   "TimerEventQueueT: SIZE must be a power of 2, from 2 to 128");
+
+  private:
+
+    volatile timer_event_t _storage[SIZE];
+
+  public:
+
+    TimerEventQueueT() : TimerEventQueue(_storage, SIZE)
+    {
+    };
+}; // class TimerEventQueueT
+
+#endif      // MEGA_AVR_TIMEREVENTQUEUE_HPP
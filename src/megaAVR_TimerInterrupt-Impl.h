@@ -32,6 +32,9 @@
 #ifndef MEGA_AVR_TIMERINTERRUPT_IMPL_H
 #define MEGA_AVR_TIMERINTERRUPT_IMPL_H
 
+// For postCallback(), after TimerInterrupt
+#include "megaAVR_TimerEventQueue.hpp"
+
 #ifndef TIMER_INTERRUPT_DEBUG
   #define TIMER_INTERRUPT_DEBUG      0
 #endif
@@ -113,9 +116,10 @@ TCB_t* TimerTCB[ NUM_HW_TIMERS ] = { &TCB0, &TCB1, &TCB2 };
   #define TCB_CLKSEL_VALUE      TCB_CLKSEL_CLKTCA_gc
   #define CLOCK_PRESCALER       64
 #else
-  // Use Timer A as clock (prescaler 64) => 250KHz
+  // TCB clock selected per timer by setFrequency() / setIntervalXX(), see TimerInterrupt::selectClock().
+  // Use Timer A as clock (prescaler 64) => 250KHz until then
   #if (_TIMERINTERRUPT_LOGLEVEL_ > 2)
-    #warning Using prescaler 64 => 250KHz
+    #warning Selecting TCB clock per timer
   #endif
 
   #define TCB_CLKSEL_VALUE      TCB_CLKSEL_CLKTCA_gc
@@ -124,6 +128,115 @@ TCB_t* TimerTCB[ NUM_HW_TIMERS ] = { &TCB0, &TCB1, &TCB2 };
 
 #define CLK_TCB_FREQ          ( F_CPU / CLOCK_PRESCALER )
 
+////////////////////////////////////////////////////////
+
+// TCB clocks, in the order tried by TimerInterrupt::selectClock()
+const uint8_t TimerInterrupt_clkSels[ NUM_TCB_CLOCKS ] =
+{
+  TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc, TCB_CLKSEL_CLKTCA_gc
+};
+
+constexpr uint32_t TimerInterrupt_gcd(const uint32_t a, const uint32_t b)
+{
+  return (b == 0) ? a : TimerInterrupt_gcd(b, a % b);
+}
+
+// Return value * num / den, or 0 if the result doesn't fit in uint32_t.
+// (value % den) * num can't overflow as num and den are reduced, small constants
+static inline uint32_t TimerInterrupt_scale(const uint32_t& value, const uint32_t& num, const uint32_t& den)
+{
+  uint32_t quotient = value / den;
+
+  if (quotient > (0xFFFFFFFFUL - num) / num)
+    return 0;
+
+  return ( quotient * num ) + ( ( (value % den) * num ) / den );
+}
+
+// value (in 1 / UNITS_PER_SECOND s) to ticks of CLOCK. The ratio CLOCK / UNITS_PER_SECOND is reduced
+// at compile time, so that the conversion needs neither float nor 64-bit math
+template<uint32_t CLOCK, uint32_t UNITS_PER_SECOND>
+static inline uint32_t TimerInterrupt_toTicks(const uint32_t& value)
+{
+  return TimerInterrupt_scale(value, CLOCK / TimerInterrupt_gcd(CLOCK, UNITS_PER_SECOND),
+                              UNITS_PER_SECOND / TimerInterrupt_gcd(CLOCK, UNITS_PER_SECOND));
+}
+
+// value (in 1 / UNITS_PER_SECOND s) to ticks of each TCB clock
+template<uint32_t UNITS_PER_SECOND>
+static inline void TimerInterrupt_toTicks(const uint32_t& value, uint32_t ticksPerClock[])
+{
+  ticksPerClock[0] = TimerInterrupt_toTicks<F_CPU, UNITS_PER_SECOND>(value);
+  ticksPerClock[1] = TimerInterrupt_toTicks<F_CPU / 2, UNITS_PER_SECOND>(value);
+  ticksPerClock[2] = TimerInterrupt_toTicks<F_CPU / 64, UNITS_PER_SECOND>(value);
+}
+
+// Select the clock as TimerInterrupt_selectClockIndex(), among all clocks or the one forced by setClockSource()
+// or USING_16MHZ, USING_8MHZ or USING_250KHZ
+uint32_t TimerInterrupt::selectClock(const uint32_t ticksPerClock[], uint8_t& clkSel)
+{
+  // No clock allowed if _clkSel isn't one of TimerInterrupt_clkSels[]
+  int8_t forcedClock = _autoClock ? TIMER_CLOCK_AUTO : NUM_TCB_CLOCKS;
+
+  for (uint8_t i = 0; !_autoClock && (i < NUM_TCB_CLOCKS); i++)
+  {
+    if (TimerInterrupt_clkSels[i] == _clkSel)
+      forcedClock = i;
+  }
+
+  int8_t selected = TimerInterrupt_selectClockIndex(ticksPerClock, forcedClock, _maxErrorPPM);
+
+  if (selected < 0)
+  {
+    // Out of range for all clocks, or for the forced clock
+    clkSel = _clkSel;
+
+    return 0;
+  }
+
+  clkSel = TimerInterrupt_clkSels[selected];
+
+  TISR_LOGINFO3(F("selectClock: clkSel = "), clkSel, F(", ticks = "), ticksPerClock[selected]);
+
+  return ticksPerClock[selected];
+}
+
+uint32_t TimerInterrupt::msToTicks(const uint32_t& interval_ms, uint8_t& clkSel)
+{
+  uint32_t ticksPerClock[NUM_TCB_CLOCKS];
+
+  TimerInterrupt_toTicks<1000UL>(interval_ms, ticksPerClock);
+
+  return selectClock(ticksPerClock, clkSel);
+}
+
+uint32_t TimerInterrupt::usToTicks(const uint32_t& interval_us, uint8_t& clkSel)
+{
+  uint32_t ticksPerClock[NUM_TCB_CLOCKS];
+
+  TimerInterrupt_toTicks<1000000UL>(interval_us, ticksPerClock);
+
+  return selectClock(ticksPerClock, clkSel);
+}
+
+uint32_t TimerInterrupt::nsToTicks(const uint32_t& interval_ns, uint8_t& clkSel)
+{
+  uint32_t ticksPerClock[NUM_TCB_CLOCKS];
+
+  TimerInterrupt_toTicks<1000000000UL>(interval_ns, ticksPerClock);
+
+  return selectClock(ticksPerClock, clkSel);
+}
+
+// Number of periods of ticks of clkSel in duration (in milliseconds).
+// 64-bit integer math as duration * clock can overflow uint32_t, but no float
+long TimerInterrupt::durationToCount(const unsigned long& duration, const uint32_t& ticks, const uint8_t& clkSel)
+{
+  uint64_t count = ( (uint64_t) duration * TimerInterrupt_clockOf(clkSel) ) / ( (uint64_t) ticks * 1000 );
+
+  return (count > 0x7FFFFFFFUL) ? 0x7FFFFFFFL : (long) count;
+}
+
 void TimerInterrupt::init(const int8_t& timer)
 {
   // Set timer specific stuff
@@ -137,7 +250,7 @@ void TimerInterrupt::init(const int8_t& timer)
   TimerTCB[timer]->CTRLB    = TCB_CNTMODE_INT_gc;                         // Use timer compare mode
   TimerTCB[timer]->CCMP     = MAX_COUNT_16BIT;                            // Value to compare with.
   TimerTCB[timer]->INTCTRL  &= ~TCB_CAPT_bm;                              // Disable the interrupt
-  TimerTCB[timer]->CTRLA    = TCB_CLKSEL_VALUE | TCB_ENABLE_bm;       // Use Timer A as clock, enable timer
+  TimerTCB[timer]->CTRLA    = _clkSel | TCB_ENABLE_bm;                    // Use selected clock, enable timer
 
   TISR_LOGWARN1(F("TCB"), timer);
 
@@ -158,30 +271,128 @@ void TimerInterrupt::init(const int8_t& timer)
 void TimerInterrupt::set_CCMP()
 {
   // Run with noInterrupt()
+  // Split _CCMPValue into _segments equal segments of at most MAX_TICKS_PER_SEGMENT ticks, the remainder
+  // being spread as one more tick on each of the first _longSegments segments.
+  // The ISR then only counts segments down, see nextSegment()
+  _segments           = TimerInterrupt_segmentsOf(_CCMPValue);
+  _segmentsRemaining  = _segments;
+  _segmentCCMP        = TimerInterrupt_segmentCCMPOf(_CCMPValue, _segments);    // TCB period is CCMP + 1 ticks
+  _longSegments       = _CCMPValue % _segments;
+
+  TimerTCB[_timer]->CCMP    = (_longSegments != 0) ? _segmentCCMP + 1 : _segmentCCMP;    // Value to compare with.
+
+  // Enable the interrupt, unless the timer only drives its EVSYS channel
+  TimerTCB[_timer]->INTCTRL = (_callback != NULL) ? TCB_CAPT_bm : 0;
+
+  // Also called from the ISR by reloadTicks(), so nothing printed here
+}
+
+void TimerInterrupt::postCallback()
+{
+  if (_params != NULL)
+    _eventQueue->post((timer_callback_p) _callback, _params, TIMER_EVENT_HW_TIMER | _timer);
+  else
+    _eventQueue->post((timer_callback) _callback, TIMER_EVENT_HW_TIMER | _timer);
+}
+
+// ticks (period in ticks of clkSel) and duration (in milliseconds).
+// Return true if ticks is OK with selected timer (CCMPValue is in range)
+bool TimerInterrupt::setPeriod(const uint32_t& ticks, const uint8_t& clkSel, timer_callback_p callback,
+                               const uint32_t& params, const unsigned long& duration)
+{
+  // ticks == 0 also flags an interval out of range from msToTicks(), usToTicks() or nsToTicks()
+  if ((_timer < 0) || (ticks == 0) || (ticks > MAX_TICKS_PER_PERIOD) )
+  {
+    TISR_LOGDEBUG(F("setPeriod error"));
+
+    return false;
+  }
+
+  // Without callback, the timer only drives its EVSYS channel, set before or after by setEventOutput() : no interrupt,
+  // so no duration and no segment. With an EVSYS channel, the event must come once per period, so no segment either
+  if ( ( (callback == NULL) && ( (duration > 0) || (ticks > MAX_TICKS_PER_SEGMENT) ) ) ||
+       ( (_eventChannel != TIMER_NO_EVENT_CHANNEL) && (ticks > MAX_TICKS_PER_SEGMENT) ) )
+  {
+    TISR_LOGDEBUG(F("setPeriod: callback or period not allowed with EVSYS output"));
+
+    return false;
+  }
+
+  // Features removed from ISR(TCBn_INT_vect) by the TIMERn_ISR_POLICY of this timer
+  if ( ( (_policy & TIMER_ISR_NO_DURATION) && (duration > 0) ) ||
+       ( (_policy & TIMER_ISR_NO_LONG_PERIOD) && (ticks > MAX_TICKS_PER_SEGMENT) ) ||
+       ( (_policy & TIMER_ISR_NO_PARAMS) && (params != 0) ) )
+  {
+    TISR_LOGDEBUG1(F("setPeriod: not allowed by ISR policy "), _policy);
+
+    return false;
+  }
+
+  long toggle_count;
+
+  // Calculate the toggle count. Duration must be at least longer then one cycle
+  if (duration > 0)
+  {
+    toggle_count = durationToCount(duration, ticks, clkSel);
+
+    TISR_LOGINFO1(F("setPeriod => _toggle_count = "), toggle_count);
+    TISR_LOGINFO3(F("Ticks ="), ticks, F(", duration = "), duration);
+
+    if (toggle_count < 1)
+    {
+      TISR_LOGDEBUG(F("setPeriod: _toggle_count < 1 error"));
+
+      return false;
+    }
+  }
+  else
+  {
+    toggle_count = -1;
+  }
+
+  //Timer0-3 are 16 bit timers, meaning it can store a maximum counter value of 65535.
+
+  noInterrupts();
+
+  _toggle_count = toggle_count;
+  _callback     = (void*) callback;
+  _params       = reinterpret_cast<void*>(params);
+
+  _CCMPValue = ticks;
+
+  _clkSel = clkSel;
+
+  if ( (TimerTCB[_timer]->CTRLA & TCB_CLKSEL_gm) != _clkSel )
+  {
+    uint8_t enable = TimerTCB[_timer]->CTRLA & TCB_ENABLE_bm;
+
+    // Switch clock and restart count, the old count being in ticks of the old clock. Stopped meanwhile, so that
+    // no tick of either clock is counted between the switch and the restart
+    TimerTCB[_timer]->CTRLA = 0;                    // Disable timer while reconfiguring
+    TimerTCB[_timer]->CTRLA = _clkSel;
+    TimerTCB[_timer]->CNT   = 0;
+    TimerTCB[_timer]->CTRLA = _clkSel | enable;
+  }
+
+  TISR_LOGINFO3(F("Ticks = "), ticks, F(", Clock = "), getClockFrequency());
+
   // Set the CCMP for the given timer,
   // set the toggle count,
   // then turn on the interrupts
-  uint32_t _CCMPValueToUse;
-
-  _CCMPValueToUse = min(MAX_COUNT_16BIT, _CCMPValueRemaining);
-  _CCMPValueRemaining -= _CCMPValueToUse;
+  set_CCMP();
 
-  TimerTCB[_timer]->CCMP    = _CCMPValueToUse;    // Value to compare with.
-
-  TimerTCB[_timer]->INTCTRL = TCB_CAPT_bm; // Enable the interrupt
+  interrupts();
 
   TISR_LOGDEBUG(F("=================="));
   TISR_LOGDEBUG1(F("set_CCMP, Timer = "), _timer);
+  TISR_LOGDEBUG3(F("Segments = "), _segments, F(", long = "), _longSegments);
   TISR_LOGDEBUG1(F("CTRLB   = "), TimerTCB[_timer]->CTRLB);
   TISR_LOGDEBUG1(F("CCMP    = "), TimerTCB[_timer]->CCMP);
   TISR_LOGDEBUG1(F("INTCTRL = "), TimerTCB[_timer]->INTCTRL);
   TISR_LOGDEBUG1(F("CTRLA   = "), TimerTCB[_timer]->CTRLA);
   TISR_LOGDEBUG(F("=================="));
 
-  // Flag _CCMPValue == 0 => end of long timer
-  if (_CCMPValueRemaining == 0)
-    _timerDone = true;
-
+  return true;
 }
 
 // frequency (in hertz) and duration (in milliseconds).
@@ -193,58 +404,273 @@ bool TimerInterrupt::setFrequency(const float& frequency, timer_callback_p callb
   float frequencyLimit = frequency * 17179.840;
 
   // Limit frequency to larger than (0.00372529 / 64) Hz or interval 17179.840s / 17179840 ms to avoid uint32_t overflow
-  if ((_timer < 0) || (callback == NULL) || ((frequencyLimit) < 1) )
+  if ((_timer < 0) || ((frequencyLimit) < 1) )
   {
     TISR_LOGDEBUG(F("setFrequency error"));
 
     return false;
   }
-  else
+
+  uint32_t ticksPerClock[NUM_TCB_CLOCKS];
+
+  for (uint8_t i = 0; i < NUM_TCB_CLOCKS; i++)
+    ticksPerClock[i] = TimerInterrupt_frequencyToTicks(F_CPU / TimerInterrupt_dividerOf(i), frequency);
+
+  uint8_t clkSel;
+  uint32_t ticks = selectClock(ticksPerClock, clkSel);
+
+  TISR_LOGINFO3(F("Frequency = "), frequency, F(", Clock = "), TimerInterrupt_clockOf(clkSel));
+
+  return setPeriod(ticks, clkSel, callback, params, duration);
+}
+
+bool TimerInterrupt::setPWM8(const uint8_t& top, const uint8_t& duty)
+{
+  if ( (_timer < 0) || (top < 1) )
+  {
+    TISR_LOGDEBUG(F("setPWM8 error"));
+
+    return false;
+  }
+
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
+
+  tcb->CTRLA    = 0;                                      // Disable timer while reconfiguring
+  tcb->INTCTRL  = 0;                                      // No interrupt in PWM8 mode
+  tcb->INTFLAGS = TCB_CAPT_bm;
+  tcb->CTRLB    = TCB_CNTMODE_PWM8_gc | TCB_CCMPEN_bm;    // 8-bit PWM, output on WO pin
+  tcb->CNT      = 0;
+  tcb->CCMP     = ( (uint16_t) duty << 8 ) | top;         // CCMPH = duty, CCMPL = top
+  tcb->CTRLA    = _clkSel | TCB_ENABLE_bm;
+
+  _pwmTop   = top;
+  _pwmDuty  = duty;
+
+  interrupts();
+
+  TISR_LOGINFO3(F("setPWM8, top = "), top, F(", duty = "), duty);
+
+  return true;
+}
+
+bool TimerInterrupt::setPWM8Frequency(const uint32_t& frequency, const uint8_t& duty)
+{
+  if (frequency == 0)
   {
-    // Calculate the toggle count. Duration must be at least longer then one cycle
-    if (duration > 0)
+    TISR_LOGDEBUG(F("setPWM8Frequency error"));
+
+    return false;
+  }
+
+  // Fastest clock first, giving the most duty steps
+  for (uint8_t i = 0; i < NUM_TCB_CLOCKS; i++)
+  {
+    uint8_t clkSel = TimerInterrupt_clkSels[i];
+
+    if (!_autoClock && (clkSel != _clkSel))
+      continue;
+
+    uint32_t ticks = ( TimerInterrupt_clockOf(clkSel) + (frequency / 2) ) / frequency;
+
+    if ( (ticks >= 2) && (ticks <= 256) )
     {
-      _toggle_count = frequency * duration / 1000;
+      _clkSel = clkSel;
+
+      TISR_LOGINFO3(F("PWM8 Frequency = "), frequency, F(", Clock = "), TimerInterrupt_clockOf(clkSel));
+
+      return setPWM8(ticks - 1, TimerInterrupt_PWM8DutyTicks(duty, ticks));
+    }
+  }
+
+  TISR_LOGDEBUG1(F("setPWM8Frequency: out of range, frequency = "), frequency);
+
+  return false;
+}
+
+bool TimerInterrupt::setPWM8DutyTicks(const uint8_t& duty)
+{
+  // Not in PWM8 mode, e.g. periodic interrupt : CCMP is the period
+  if ( (_timer < 0) || ( (TimerTCB[_timer]->CTRLB & TCB_CNTMODE_gm) != TCB_CNTMODE_PWM8_gc ) )
+  {
+    TISR_LOGDEBUG(F("setPWM8DutyTicks error"));
+
+    return false;
+  }
+
+  TCB_t* tcb = TimerTCB[_timer];
 
-      TISR_LOGINFO1(F("setFrequency => _toggle_count = "), _toggle_count);
-      TISR_LOGINFO3(F("Frequency ="), frequency, F(", duration = "), duration);
+  // CCMPH can't be written alone : CCMPL is written from TEMP at the same time, so always write CCMP in full.
+  // Raising the duty never glitches : the output is either still high, to be cleared at the new duty,
+  // or already low for this period.
+  // Lowering the duty while CNT is in [duty, _pwmDuty) misses both matches, keeping the output high for a whole
+  // period. So wait for CNT out of that window, widened by the ticks counted between reading CNT and writing CCMP
+  uint16_t ccmp = ( (uint16_t) duty << 8 ) | _pwmTop;
+  uint8_t  sreg = SREG;
 
-      if (_toggle_count < 1)
+  noInterrupts();
+
+  if (duty < _pwmDuty)
+  {
+    uint8_t margin  = (_clkSel == TCB_CLKSEL_CLKDIV1_gc) ? 16 : ( (_clkSel == TCB_CLKSEL_CLKDIV2_gc) ? 8 : 1 );
+    int16_t low     = (int16_t) duty - margin;
+    int16_t period  = (int16_t) _pwmTop + 1;
+
+    // Else the period is too short to time the write, and one period may glitch
+    if ( (_pwmDuty - low) < period )
+    {
+      while (true)
       {
-        TISR_LOGDEBUG(F("setFrequency: _toggle_count < 1 error"));
+        int16_t count = tcb->CNTL;
 
-        return false;
+        if ( !( ( (count >= low) && (count < _pwmDuty) ) || ( (low < 0) && (count >= low + period) ) ) )
+          break;
+
+        // Interrupts served meanwhile, if they were enabled
+        SREG = sreg;
+        noInterrupts();
       }
     }
-    else
-    {
-      _toggle_count = -1;
-    }
+  }
+
+  tcb->CCMP = ccmp;
+  _pwmDuty  = duty;
+
+  SREG = sreg;
+
+  return true;
+}
+
+void TimerInterrupt::stopPWM8()
+{
+  if (_timer < 0)
+    return;
+
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
+
+  tcb->CTRLA  = _clkSel;                  // Disable timer
+  tcb->CTRLB  = TCB_CNTMODE_INT_gc;       // Back to timer compare mode, WO pin released
+  tcb->CCMP   = MAX_COUNT_16BIT;
+
+  _pwmTop   = 0;
+  _pwmDuty  = 0;
+
+  interrupts();
+}
+
+bool TimerInterrupt::setOneShot(const uint16_t& ticks, const uint8_t& channel, timer_callback_p callback,
+                                const uint32_t& params)
+{
+  if ( (_timer < 0) || (ticks == 0) || (channel >= NUM_EVSYS_CHANNELS) )
+  {
+    TISR_LOGDEBUG(F("setOneShot error"));
+
+    return false;
+  }
+
+  if ( (_policy & TIMER_ISR_NO_PARAMS) && (params != 0) )
+  {
+    TISR_LOGDEBUG1(F("setOneShot: not allowed by ISR policy "), _policy);
+
+    return false;
+  }
+
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
 
-    //Timer0-3 are 16 bit timers, meaning it can store a maximum counter value of 65535.
+  tcb->CTRLA    = 0;                                      // Disable timer while reconfiguring
+  tcb->INTCTRL  = 0;
+  tcb->INTFLAGS = TCB_CAPT_bm;
 
-    noInterrupts();
+  // One interrupt, at the end of each pulse
+  _toggle_count       = -1;
+  _callback           = (void*) callback;
+  _params             = reinterpret_cast<void*>(params);
+  _CCMPValue          = ticks;
+  _segments           = 1;
+  _segmentsRemaining  = 1;
+  _segmentCCMP        = ticks;
+  _longSegments       = 0;
+  _oneShotChannel     = channel;
 
-    _frequency = frequency;
-    _callback  = (void*) callback;
-    _params    = reinterpret_cast<void*>(params);
+  TimerInterrupt_setTimerEventUser(_timer, channel);
 
-    _timerDone = false;
+  // Asynchronous output, set by the event itself rather than at the next TCB clock
+  tcb->CTRLB    = TCB_CNTMODE_SINGLE_gc | TCB_CCMPEN_bm | TCB_ASYNC_bm;
+  tcb->EVCTRL   = TCB_CAPTEI_bm;
+  tcb->CNT      = 0;
+  tcb->CCMP     = ticks;
 
-    _CCMPValue = _CCMPValueRemaining = (uint32_t) (CLK_TCB_FREQ / frequency);
+  if (callback != NULL)
+    tcb->INTCTRL = TCB_CAPT_bm;
 
-    TISR_LOGINFO3(F("Frequency = "), frequency, F(", CLK_TCB_FREQ = "), CLK_TCB_FREQ);
-    TISR_LOGINFO1(F("setFrequency: _CCMPValueRemaining = "), _CCMPValueRemaining);
+  tcb->CTRLA    = _clkSel | TCB_ENABLE_bm;
 
-    // Set the CCMP for the given timer,
-    // set the toggle count,
-    // then turn on the interrupts
-    set_CCMP();
+  interrupts();
+
+  TISR_LOGINFO3(F("setOneShot, ticks = "), ticks, F(", Clock = "), getClockFrequency());
 
-    interrupts();
+  return true;
+}
+
+void TimerInterrupt::stopOneShot()
+{
+  if (_timer < 0)
+    return;
 
-    return true;
+  TCB_t* tcb = TimerTCB[_timer];
+
+  noInterrupts();
+
+  tcb->CTRLA    = _clkSel;                // Disable timer
+  tcb->INTCTRL  = 0;
+  tcb->INTFLAGS = TCB_CAPT_bm;
+  tcb->EVCTRL   = 0;
+  tcb->CTRLB    = TCB_CNTMODE_INT_gc;     // Back to timer compare mode, WO pin released
+  tcb->CCMP     = MAX_COUNT_16BIT;
+
+  TimerInterrupt_clearTimerEventUser(_timer);
+
+  interrupts();
+}
+
+bool TimerInterrupt::setEventOutput(const uint8_t& channel)
+{
+  if ( (_timer < 0) || (channel >= NUM_EVSYS_CHANNELS) || (_CCMPValue > MAX_TICKS_PER_SEGMENT) )
+  {
+    TISR_LOGDEBUG(F("setEventOutput error"));
+
+    return false;
   }
+
+  noInterrupts();
+
+  clearEventOutput();
+
+  _eventChannel = channel;
+  TimerInterrupt_setEventGenerator(channel, TimerInterrupt_eventGeneratorOf(_timer));
+
+  interrupts();
+
+  TISR_LOGINFO3(F("setEventOutput, Timer = "), _timer, F(", EVSYS channel = "), channel);
+
+  return true;
+}
+
+void TimerInterrupt::clearEventOutput()
+{
+  if (_eventChannel == TIMER_NO_EVENT_CHANNEL)
+    return;
+
+  // Only if still driven by this timer
+  if ( (&EVSYS.CHANNEL0)[_eventChannel] == TimerInterrupt_eventGeneratorOf(_timer) )
+    (&EVSYS.CHANNEL0)[_eventChannel] = 0;
+
+  _eventChannel = TIMER_NO_EVENT_CHANNEL;
 }
 
 void TimerInterrupt::detachInterrupt()
@@ -267,7 +693,7 @@ void TimerInterrupt::reattachInterrupt(const unsigned long& duration)
   // Calculate the toggle count
   if (duration > 0)
   {
-    _toggle_count = _frequency * duration / 1000;
+    _toggle_count = durationToCount(duration, _CCMPValue, _clkSel);
   }
   else
   {
@@ -275,23 +701,36 @@ void TimerInterrupt::reattachInterrupt(const unsigned long& duration)
   }
 
   // Set interrupt flag
-  TimerTCB[_timer]->INTCTRL  |= TCB_CAPT_bm;    // Enable the interrupt
+  if (_callback != NULL)
+    TimerTCB[_timer]->INTCTRL  |= TCB_CAPT_bm;  // Enable the interrupt
   TimerTCB[_timer]->CTRLA    |= TCB_ENABLE_bm;  // Enable timer
 
   interrupts();
 }
 
-// Just stop clock source, still keep the count
-// To fix this.
+// Just stop clock source, still keep the count.
+// Only CTRLA.ENABLE is cleared : CNT, CCMP, the interrupt enable, the segments and _toggle_count are kept.
+// A compare match flagged just before is still served, the period then continuing from 0 at resume.
+// May be called from a callback, as the interrupt state is restored
 void TimerInterrupt::pauseTimer()
 {
-  detachInterrupt();
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  TimerTCB[_timer]->CTRLA &= ~TCB_ENABLE_bm;    // Stop counting
+
+  SREG = sreg;
 }
 
-// Just reconnect clock source, continue from the current count
+// Just reconnect clock source, continue from the current count, within the same segment and period
 void TimerInterrupt::resumeTimer()
 {
-  reattachInterrupt();
+  uint8_t sreg = SREG;
+  noInterrupts();
+
+  TimerTCB[_timer]->CTRLA |= TCB_ENABLE_bm;     // Count on from CNT
+
+  SREG = sreg;
 }
 
 ////////////////////////////////////////////////////////
@@ -325,49 +764,11 @@ void TimerInterrupt::resumeTimer()
 #ifndef TIMER0_INSTANTIATED
 // To force pre-instatiate only once
 #define TIMER0_INSTANTIATED
-TimerInterrupt ITimer0(HW_TIMER_0);
+TimerInterrupt ITimer0(HW_TIMER_0, TIMER0_ISR_POLICY);
 
 ISR(TCB0_INT_vect)
 {
-  long countLocal = ITimer0.getCount();
-
-  if (ITimer0.getTimer() == 0)
-  {
-    if (countLocal != 0)
-    {
-      if (ITimer0.checkTimerDone())
-      {
-        TISR_LOGDEBUG3(("T0 callback, _CCMPValueRemaining = "), ITimer0.get_CCMPValueRemaining(), (", millis = "), millis());
-
-        ITimer0.callback();
-
-        if (ITimer0.get_CCMPValue() > MAX_COUNT_16BIT)
-        {
-          // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT
-          ITimer0.reload_CCMPValue();
-        }
-
-        if (countLocal > 0)
-          ITimer0.setCount(countLocal - 1);
-      }
-      else
-      {
-        //Deduct _CCMPValue by min(MAX_COUNT_16BIT, _CCMPValue)
-        // If _CCMPValue == 0, flag _timerDone for next cycle
-        // If last one (_CCMPValueRemaining < MAX_COUNT_16BIT) => load _CCMP register _CCMPValueRemaining
-        ITimer0.adjust_CCMPValue();
-      }
-    }
-    else
-    {
-      TISR_LOGWARN(("T0 done"));
-
-      ITimer0.detachInterrupt();
-    }
-  }
-
-  // Clear interrupt flag
-  TCB0.INTFLAGS = TCB_CAPT_bm;
+  ITimer0.handleInterrupt<TIMER0_ISR_POLICY>(TCB0);
 }
 #endif  //#ifndef TIMER0_INSTANTIATED
 #endif    //#if USE_TIMER_0
@@ -376,52 +777,14 @@ ISR(TCB0_INT_vect)
 #ifndef TIMER1_INSTANTIATED
 // To force pre-instatiate only once
 #define TIMER1_INSTANTIATED
-TimerInterrupt ITimer1(HW_TIMER_1);
+TimerInterrupt ITimer1(HW_TIMER_1, TIMER1_ISR_POLICY);
 
 // Timer0 is used for micros(), millis(), delay(), etc and can't be used
 // Pre-instatiate
 
 ISR(TCB1_INT_vect)
 {
-  long countLocal = ITimer1.getCount();
-
-  if (ITimer1.getTimer() == 1)
-  {
-    if (countLocal != 0)
-    {
-      if (ITimer1.checkTimerDone())
-      {
-        TISR_LOGDEBUG3(("T1 callback, _CCMPValueRemaining = "), ITimer1.get_CCMPValueRemaining(), (", millis = "), millis());
-
-        ITimer1.callback();
-
-        if (ITimer1.get_CCMPValue() > MAX_COUNT_16BIT)
-        {
-          // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
-          ITimer1.reload_CCMPValue();
-        }
-
-        if (countLocal > 0)
-          ITimer1.setCount(countLocal - 1);
-      }
-      else
-      {
-        //Deduct _CCMPValue by min(MAX_COUNT_16BIT, _CCMPValue)
-        // If _CCMPValue == 0, flag _timerDone for next cycle
-        // If last one (_CCMPValueRemaining < MAX_COUNT_16BIT) => load _CCMP register _CCMPValueRemaining
-        ITimer1.adjust_CCMPValue();
-      }
-    }
-    else
-    {
-      TISR_LOGWARN(("T1 done"));
-
-      ITimer1.detachInterrupt();
-    }
-  }
-
-  // Clear interrupt flag
-  TCB1.INTFLAGS = TCB_CAPT_bm;
+  ITimer1.handleInterrupt<TIMER1_ISR_POLICY>(TCB1);
 }
 
 #endif  //#ifndef TIMER1_INSTANTIATED
@@ -430,49 +793,11 @@ ISR(TCB1_INT_vect)
 #if USE_TIMER_2
 #ifndef TIMER2_INSTANTIATED
 #define TIMER2_INSTANTIATED
-TimerInterrupt ITimer2(HW_TIMER_2);
+TimerInterrupt ITimer2(HW_TIMER_2, TIMER2_ISR_POLICY);
 
 ISR(TCB2_INT_vect)
 {
-  long countLocal = ITimer2.getCount();
-
-  if (ITimer2.getTimer() == 2)
-  {
-    if (countLocal != 0)
-    {
-      if (ITimer2.checkTimerDone())
-      {
-        TISR_LOGDEBUG3(("T2 callback, _CCMPValueRemaining = "), ITimer2.get_CCMPValueRemaining(), (", millis = "), millis());
-
-        ITimer2.callback();
-
-        if (ITimer2.get_CCMPValue() > MAX_COUNT_16BIT)
-        {
-          // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
-          ITimer2.reload_CCMPValue();
-        }
-
-        if (countLocal > 0)
-          ITimer2.setCount(countLocal - 1);
-
-      }
-      else
-      {
-        //Deduct _CCMPValue by min(MAX_COUNT_8BIT, _CCMPValue)
-        // If _CCMPValue == 0, flag _timerDone for next cycle
-        ITimer2.adjust_CCMPValue();
-      }
-    }
-    else
-    {
-      TISR_LOGWARN(("T2 done"));
-
-      ITimer2.detachInterrupt();
-    }
-  }
-
-  // Clear interrupt flag
-  TCB2.INTFLAGS = TCB_CAPT_bm;
+  ITimer2.handleInterrupt<TIMER2_ISR_POLICY>(TCB2);
 }
 #endif  //#ifndef TIMER2_INSTANTIATED
 #endif    //#if USE_TIMER_2
@@ -482,49 +807,11 @@ ISR(TCB2_INT_vect)
 #ifndef TIMER3_INSTANTIATED
 // To force pre-instatiate only once
 #define TIMER3_INSTANTIATED
-TimerInterrupt ITimer3(HW_TIMER_3);
+TimerInterrupt ITimer3(HW_TIMER_3, TIMER3_ISR_POLICY);
 
 ISR(TCB3_INT_vect)
 {
-  long countLocal = ITimer3.getCount();
-
-  if (ITimer3.getTimer() == 3)
-  {
-    if (countLocal != 0)
-    {
-      if (ITimer3.checkTimerDone())
-      {
-        TISR_LOGDEBUG3(("T3 callback, _CCMPValueRemaining = "), ITimer3.get_CCMPValueRemaining(), (", millis = "), millis());
-
-        ITimer3.callback();
-
-        if (ITimer3.get_CCMPValue() > MAX_COUNT_16BIT)
-        {
-          // To reload _CCMPValueRemaining as well as _CCMP register to MAX_COUNT_16BIT if _CCMPValueRemaining > MAX_COUNT_16BIT
-          ITimer3.reload_CCMPValue();
-        }
-
-        if (countLocal > 0)
-          ITimer3.setCount(countLocal - 1);
-      }
-      else
-      {
-        //Deduct _CCMPValue by min(MAX_COUNT_16BIT, _CCMPValue)
-        // If _CCMPValue == 0, flag _timerDone for next cycle
-        // If last one (_CCMPValueRemaining < MAX_COUNT_16BIT) => load _CCMP register _CCMPValueRemaining
-        ITimer3.adjust_CCMPValue();
-      }
-    }
-    else
-    {
-      TISR_LOGWARN(("T3 done"));
-
-      ITimer3.detachInterrupt();
-    }
-  }
-
-  // Clear interrupt flag
-  TCB3.INTFLAGS = TCB_CAPT_bm;
+  ITimer3.handleInterrupt<TIMER3_ISR_POLICY>(TCB3);
 }
 
 #endif  //#ifndef TIMER3_INSTANTIATED
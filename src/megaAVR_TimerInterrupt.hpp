@@ -94,7 +94,146 @@
 #include "Arduino.h"
 #include "pins_arduino.h"
 
-#define MAX_COUNT_16BIT           65535UL
+// MAX_TICKS_PER_SEGMENT, MAX_TICKS_PER_PERIOD, NUM_TCB_CLOCKS and the clock / period math, also used on host
+#include "megaAVR_TimerClock.h"
+
+// For setClockSource(), to let setFrequency() / setIntervalXX() select the TCB clock
+#define TCB_CLKSEL_AUTO           0xFF
+
+// Selecting USING_16MHZ, USING_8MHZ or USING_250KHZ forces the same TCB clock for all timers.
+// Otherwise the clock is selected per timer, and is 250KHz until then
+#if USING_16MHZ
+  #define TIMER_INTERRUPT_AUTO_CLOCK        false
+  #define TIMER_INTERRUPT_DEFAULT_CLKSEL    TCB_CLKSEL_CLKDIV1_gc
+#elif USING_8MHZ
+  #define TIMER_INTERRUPT_AUTO_CLOCK        false
+  #define TIMER_INTERRUPT_DEFAULT_CLKSEL    TCB_CLKSEL_CLKDIV2_gc
+#elif USING_250KHZ
+  #define TIMER_INTERRUPT_AUTO_CLOCK        false
+  #define TIMER_INTERRUPT_DEFAULT_CLKSEL    TCB_CLKSEL_CLKTCA_gc
+#else
+  #define TIMER_INTERRUPT_AUTO_CLOCK        true
+  #define TIMER_INTERRUPT_DEFAULT_CLKSEL    TCB_CLKSEL_CLKTCA_gc
+#endif
+
+#ifndef TIMER_INTERRUPT_MAX_ERROR_PPM
+  // Default max error (in ppm) accepted when selecting the TCB clock. Can be changed per timer by setMaxErrorPPM()
+  #define TIMER_INTERRUPT_MAX_ERROR_PPM   1000UL
+#endif
+
+#ifndef TIMER_INTERRUPT_USE_STATS
+  // Latency and duration statistics of TimerInterrupt callbacks, see getStats(). Nothing is compiled in if false
+  #define TIMER_INTERRUPT_USE_STATS       false
+#endif
+
+#ifndef TIMER_STATS_HISTOGRAM_BINS
+  // Bins of timer_stats_t::histogram, 2 bytes each : latencies of 0, 1, 2-3, 4-7, ... ticks, the last one taking the rest
+  #define TIMER_STATS_HISTOGRAM_BINS      12
+#endif
+
+// Statistics of the callbacks of a timer, in ticks of the TCB clock of a TimerInterrupt, or in units of
+// ISR_Timer::now(). Latency is from the deadline (compare match) to the ISR entry, or callback start for an
+// ISR_Timer, and duration is the callback run time. Min, max and histogram saturate at 0xFFFF
+typedef struct
+{
+  uint32_t  calls;
+  uint32_t  latencySum;
+  uint32_t  durationSum;
+  uint16_t  latencyMin;
+  uint16_t  latencyMax;
+  uint16_t  durationMin;
+  uint16_t  durationMax;
+  uint16_t  missed;         // deadlines missed : callback running into the next period, or periods skipped
+  uint16_t  histogram[ TIMER_STATS_HISTOGRAM_BINS ];
+} timer_stats_t;
+
+inline void TimerInterrupt_resetStats(timer_stats_t& stats)
+{
+  stats.calls       = 0;
+  stats.latencySum  = 0;
+  stats.durationSum = 0;
+  stats.latencyMin  = 0xFFFF;
+  stats.latencyMax  = 0;
+  stats.durationMin = 0xFFFF;
+  stats.durationMax = 0;
+  stats.missed      = 0;
+
+  for (uint8_t bin = 0; bin < TIMER_STATS_HISTOGRAM_BINS; bin++)
+    stats.histogram[bin] = 0;
+}
+
+// From ISR
+inline void TimerInterrupt_addStats(timer_stats_t& stats, const uint32_t& latency, const uint32_t& duration)
+{
+  uint16_t latency16  = (latency > 0xFFFF) ? 0xFFFF : latency;
+  uint16_t duration16 = (duration > 0xFFFF) ? 0xFFFF : duration;
+
+  stats.calls++;
+  stats.latencySum  += latency;
+  stats.durationSum += duration;
+
+  if (latency16 < stats.latencyMin)
+    stats.latencyMin = latency16;
+
+  if (latency16 > stats.latencyMax)
+    stats.latencyMax = latency16;
+
+  if (duration16 < stats.durationMin)
+    stats.durationMin = duration16;
+
+  if (duration16 > stats.durationMax)
+    stats.durationMax = duration16;
+
+  // Bit length of latency
+  uint8_t bin = 0;
+
+  for (uint16_t value = latency16; (value != 0) && (bin < TIMER_STATS_HISTOGRAM_BINS - 1); value >>= 1)
+    bin++;
+
+  if (stats.histogram[bin] != 0xFFFF)
+    stats.histogram[bin]++;
+}
+
+// From ISR
+inline void TimerInterrupt_addMissed(timer_stats_t& stats, const uint32_t& missed)
+{
+  stats.missed = ( (uint32_t) stats.missed + missed > 0xFFFF ) ? 0xFFFF : (stats.missed + missed);
+}
+
+inline uint32_t TimerInterrupt_meanLatencyOf(const timer_stats_t& stats)
+{
+  return (stats.calls == 0) ? 0 : (stats.latencySum / stats.calls);
+}
+
+inline uint32_t TimerInterrupt_meanDurationOf(const timer_stats_t& stats)
+{
+  return (stats.calls == 0) ? 0 : (stats.durationSum / stats.calls);
+}
+
+// TCB clock (in Hz) for clkSel. TCA clock is CLK_PER / 64, as configured by the core
+constexpr uint32_t TimerInterrupt_clockOf(const uint8_t clkSel)
+{
+  return F_CPU / ( (clkSel == TCB_CLKSEL_CLKDIV1_gc) ? 1 : ( (clkSel == TCB_CLKSEL_CLKDIV2_gc) ? 2 : 64 ) );
+}
+
+// Frequencies (in Hz) reachable in PWM8 mode with clkSel, from clock / 256 (top = 255) to clock / 2 (top = 1)
+constexpr uint32_t TimerInterrupt_PWM8MinFrequency(const uint8_t clkSel)
+{
+  return TimerInterrupt_clockOf(clkSel) / 256;
+}
+
+constexpr uint32_t TimerInterrupt_PWM8MaxFrequency(const uint8_t clkSel)
+{
+  return TimerInterrupt_clockOf(clkSel) / 2;
+}
+
+// PWM8 high time (in ticks) for duty (0-255, as analogWrite()) and a period of ticks (2-256) :
+// 255 => always high if ticks < 256
+constexpr uint8_t TimerInterrupt_PWM8DutyTicks(const uint8_t duty, const uint16_t ticks)
+{
+  return ( ( ( (uint16_t) duty * ticks ) + 127 ) / 255 > 255 ) ? 255 : ( ( (uint16_t) duty * ticks ) + 127 ) / 255;
+}
+
 
 typedef void (*timer_callback)();
 typedef void (*timer_callback_p)(void *);
@@ -109,47 +248,204 @@ enum
   NUM_HW_TIMERS
 };
 
+// Defined in megaAVR_TimerInterrupt-Impl.h
+extern TCB_t* TimerTCB[ NUM_HW_TIMERS ];
+
+// EVSYS has 8 channels. An event user is connected to channel n by writing n + 1 into its USERxxx register
+#define NUM_EVSYS_CHANNELS        8
+
+// Connect EVSYS channel to generator, e.g. EVSYS_GENERATOR_PORT0_PIN2_gc. See iom4809.h for the generators
+// each channel can select. Return false if channel is out of range
+inline bool TimerInterrupt_setEventGenerator(const uint8_t& channel, const uint8_t& generator)
+{
+  if (channel >= NUM_EVSYS_CHANNELS)
+    return false;
+
+  (&EVSYS.CHANNEL0)[channel] = generator;
+
+  return true;
+}
+
+// Connect event user of TCBn (EVSYS.USERTCBn) to EVSYS channel
+inline void TimerInterrupt_setTimerEventUser(const uint8_t& timerNo, const uint8_t& channel)
+{
+  (&EVSYS.USERTCB0)[timerNo] = channel + 1;
+}
+
+// Disconnect event user of TCBn from its EVSYS channel
+inline void TimerInterrupt_clearTimerEventUser(const uint8_t& timerNo)
+{
+  (&EVSYS.USERTCB0)[timerNo] = 0;
+}
+
+// Connect any event user, e.g. EVSYS.USERADC0 or EVSYS.USEREVOUTA, to EVSYS channel
+inline void TimerInterrupt_setEventUser(register8_t& user, const uint8_t& channel)
+{
+  user = channel + 1;
+}
+
+// EVSYS generator of the compare (CAPT) event of TCBn : EVSYS_GENERATOR_TCB0_CAPT_gc, then 2 apart
+constexpr uint8_t TimerInterrupt_eventGeneratorOf(const uint8_t timerNo)
+{
+  return EVSYS_GENERATOR_TCB0_CAPT_gc + (2 * timerNo);
+}
+
+// For setEventOutput(), no EVSYS channel
+#define TIMER_NO_EVENT_CHANNEL    0xFF
+
+// ISR policies. Each flag removes from ISR(TCBn_INT_vect) the code for a feature the timer doesn't use.
+// Select per timer, before #include "megaAVR_TimerInterrupt.h", e.g.
+// #define TIMER1_ISR_POLICY    ( TIMER_ISR_NO_DURATION | TIMER_ISR_NO_LONG_PERIOD | TIMER_ISR_NO_PARAMS )
+#define TIMER_ISR_POLICY_FULL       0x00
+#define TIMER_ISR_NO_DURATION       0x01      // Run indefinitely only, duration must be 0
+#define TIMER_ISR_NO_LONG_PERIOD    0x02      // Period up to MAX_TICKS_PER_SEGMENT only, no segment counting
+#define TIMER_ISR_NO_PARAMS         0x04      // Callback without parameter only
+#define TIMER_ISR_NO_DEFER          0x08      // Callback called from ISR only, no setEventQueue()
+#define TIMER_ISR_POLICY_MINIMAL    ( TIMER_ISR_NO_DURATION | TIMER_ISR_NO_LONG_PERIOD | TIMER_ISR_NO_PARAMS | \
+                                      TIMER_ISR_NO_DEFER )
+
+#ifndef TIMER0_ISR_POLICY
+  #define TIMER0_ISR_POLICY         TIMER_ISR_POLICY_FULL
+#endif
+
+#ifndef TIMER1_ISR_POLICY
+  #define TIMER1_ISR_POLICY         TIMER_ISR_POLICY_FULL
+#endif
+
+#ifndef TIMER2_ISR_POLICY
+  #define TIMER2_ISR_POLICY         TIMER_ISR_POLICY_FULL
+#endif
+
+#ifndef TIMER3_ISR_POLICY
+  #define TIMER3_ISR_POLICY         TIMER_ISR_POLICY_FULL
+#endif
+
+constexpr uint8_t TimerInterrupt_policyOf(const uint8_t timerNo)
+{
+  return (timerNo == HW_TIMER_0) ? TIMER0_ISR_POLICY : ( (timerNo == HW_TIMER_1) ? TIMER1_ISR_POLICY :
+         ( (timerNo == HW_TIMER_2) ? TIMER2_ISR_POLICY : TIMER3_ISR_POLICY ) );
+}
+
+template<uint8_t TIMER_NO, uint32_t FREQUENCY_HZ, uint32_t FREQUENCY_DIV, uint32_t TOLERANCE_PPM>
+class TimerInterruptFixed;
+
+class TimerEventQueue;
 
 class TimerInterrupt
 {
   private:
 
-    bool            _timerDone;
+    template<uint8_t TIMER_NO, uint32_t FREQUENCY_HZ, uint32_t FREQUENCY_DIV, uint32_t TOLERANCE_PPM>
+    friend class TimerInterruptFixed;
+
     int8_t          _timer;
-    uint32_t        _CCMPValue;
-    uint32_t        _CCMPValueRemaining;
+    uint8_t         _policy;          // TIMER_ISR_XXX flags of ISR(TCBn_INT_vect) for this timer
+    uint8_t         _clkSel;          // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc
+    bool            _autoClock;       // true if clock is selected by setFrequency() / setIntervalXX()
+    uint32_t        _maxErrorPPM;
+    uint32_t        _CCMPValue;         // period, in ticks
+    uint16_t        _segments;          // number of segments the period is split into
+    uint16_t        _segmentsRemaining;
+    uint16_t        _segmentCCMP;       // CCMP for a segment, i.e. its length - 1
+    uint16_t        _longSegments;      // number of segments, at start of period, one tick longer for the remainder
     volatile long   _toggle_count;
-    double           _frequency;
+    uint8_t         _pwmTop;            // PWM8 period - 1, in ticks
+    uint8_t         _pwmDuty;           // PWM8 high time, in ticks
+    uint8_t         _oneShotChannel;    // EVSYS channel triggering the one-shot
+    uint8_t         _eventChannel;      // EVSYS channel driven by the compare event, or TIMER_NO_EVENT_CHANNEL
 
     void*           _callback;        // pointer to the callback function
     void*           _params;          // function parameter
 
+    TimerEventQueue* _eventQueue;     // callback posted there instead of called, if not NULL
+
+#if TIMER_INTERRUPT_USE_STATS
+    timer_stats_t   _stats;           // written by the ISR only
+#endif
+
+    // Split _CCMPValue into segments and load CCMP for the first one
     void set_CCMP();
 
+    // Post the callback to _eventQueue, with TIMER_EVENT_HW_TIMER | timer number as event id. From ISR
+    void postCallback();
+
+    // ticksPerClock[] holds the ticks for each of the NUM_TCB_CLOCKS clocks, 0 if out of range.
+    // Return the ticks for the clock selected into clkSel, 0 if out of range
+    uint32_t selectClock(const uint32_t ticksPerClock[], uint8_t& clkSel);
+
+    // Integer-only conversions to ticks of the clock selected into clkSel. Return 0 if interval is out of range
+    uint32_t msToTicks(const uint32_t& interval_ms, uint8_t& clkSel);
+    uint32_t usToTicks(const uint32_t& interval_us, uint8_t& clkSel);
+    uint32_t nsToTicks(const uint32_t& interval_ns, uint8_t& clkSel);
+
+    // Number of periods of ticks of clkSel in duration (in milliseconds), without float
+    static long durationToCount(const unsigned long& duration, const uint32_t& ticks, const uint8_t& clkSel);
+
+    // ticks (period in ticks of clkSel) and duration (in milliseconds). Duration = 0 => run indefinitely
+    bool setPeriod(const uint32_t& ticks, const uint8_t& clkSel, timer_callback_p callback, const uint32_t& params,
+                   const unsigned long& duration);
+
+    bool setIntervalMs(const uint32_t& interval_ms, timer_callback_p callback, const uint32_t& params,
+                       const unsigned long& duration)
+    {
+      uint8_t clkSel;
+      uint32_t ticks = msToTicks(interval_ms, clkSel);
+
+      return setPeriod(ticks, clkSel, callback, params, duration);
+    }
+
   public:
 
     TimerInterrupt()
     {
       _timer              = -1;
-      _frequency          = 0;
+      _policy             = TIMER_ISR_POLICY_FULL;
+      _clkSel             = TIMER_INTERRUPT_DEFAULT_CLKSEL;
+      _autoClock          = TIMER_INTERRUPT_AUTO_CLOCK;
+      _maxErrorPPM        = TIMER_INTERRUPT_MAX_ERROR_PPM;
       _callback           = NULL;
       _params             = NULL;
-      _timerDone          = false;
-      _CCMPValue           = 0;
-      _CCMPValueRemaining  = 0;
+      _eventQueue         = NULL;
+      _CCMPValue          = 0;
+      _segments           = 1;
+      _segmentsRemaining  = 1;
+      _segmentCCMP        = 0;
+      _longSegments       = 0;
       _toggle_count       = -1;
+      _pwmTop             = 0;
+      _pwmDuty            = 0;
+      _oneShotChannel     = 0;
+      _eventChannel       = TIMER_NO_EVENT_CHANNEL;
+
+#if TIMER_INTERRUPT_USE_STATS
+      TimerInterrupt_resetStats(_stats);
+#endif
     };
 
-    explicit TimerInterrupt(const uint8_t& timerNo)
+    explicit TimerInterrupt(const uint8_t& timerNo, const uint8_t& policy = TIMER_ISR_POLICY_FULL)
     {
       _timer              = timerNo;
-      _frequency          = 0;
+      _policy             = policy;
+      _clkSel             = TIMER_INTERRUPT_DEFAULT_CLKSEL;
+      _autoClock          = TIMER_INTERRUPT_AUTO_CLOCK;
+      _maxErrorPPM        = TIMER_INTERRUPT_MAX_ERROR_PPM;
       _callback           = NULL;
       _params             = NULL;
-      _timerDone          = false;
-      _CCMPValue           = 0;
-      _CCMPValueRemaining  = 0;
+      _eventQueue         = NULL;
+      _CCMPValue          = 0;
+      _segments           = 1;
+      _segmentsRemaining  = 1;
+      _segmentCCMP        = 0;
+      _longSegments       = 0;
       _toggle_count       = -1;
+      _pwmTop             = 0;
+      _pwmDuty            = 0;
+      _oneShotChannel     = 0;
+      _eventChannel       = TIMER_NO_EVENT_CHANNEL;
+
+#if TIMER_INTERRUPT_USE_STATS
+      TimerInterrupt_resetStats(_stats);
+#endif
     };
 
     void callback() __attribute__((always_inline))
@@ -163,6 +459,33 @@ class TimerInterrupt
       }
     }
 
+    // Deferred callback : the ISR posts it to queue, with TIMER_EVENT_HW_TIMER | timer number as event id, instead
+    // of calling it, and queue.dispatch() calls it later from loop(). NULL queue to call it from the ISR again.
+    // Returns false if not allowed by the TIMER_ISR_NO_DEFER policy of this timer
+    bool setEventQueue(TimerEventQueue* queue)
+    {
+      if ( (queue != NULL) && (_policy & TIMER_ISR_NO_DEFER) )
+      {
+        TISR_LOGDEBUG1(F("setEventQueue: not allowed by ISR policy "), _policy);
+
+        return false;
+      }
+
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      _eventQueue = queue;
+
+      SREG = sreg;
+
+      return true;
+    }
+
+    TimerEventQueue* getEventQueue()
+    {
+      return _eventQueue;
+    }
+
     void init(const int8_t& timer);
 
     void init()
@@ -179,18 +502,64 @@ class TimerInterrupt
       return setFrequency(frequency, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
     }
 
+    // Integer-only API, no float code is linked unless setFrequency() / attachInterrupt() are also used
+    // ticks (period in ticks of the current TCB clock, see getClockSource()) and duration (in milliseconds).
+    // Duration = 0 or not specified => run indefinitely
+    bool setTicks(const uint32_t& ticks, timer_callback_p callback, const uint32_t& params, const unsigned long& duration = 0)
+    {
+      return setPeriod(ticks, _clkSel, callback, params, duration);
+    }
+
+    // ticks (period in TCB clock ticks) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setTicks(const uint32_t& ticks, timer_callback callback, const unsigned long& duration = 0)
+    {
+      return setTicks(ticks, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+    }
+
+    // interval (in us) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setIntervalUs(const uint32_t& interval_us, timer_callback_p callback, const uint32_t& params,
+                       const unsigned long& duration = 0)
+    {
+      uint8_t clkSel;
+      uint32_t ticks = usToTicks(interval_us, clkSel);
+
+      return setPeriod(ticks, clkSel, callback, params, duration);
+    }
+
+    // interval (in us) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setIntervalUs(const uint32_t& interval_us, timer_callback callback, const unsigned long& duration = 0)
+    {
+      return setIntervalUs(interval_us, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+    }
+
+    // interval (in ns) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setIntervalNs(const uint32_t& interval_ns, timer_callback_p callback, const uint32_t& params,
+                       const unsigned long& duration = 0)
+    {
+      uint8_t clkSel;
+      uint32_t ticks = nsToTicks(interval_ns, clkSel);
+
+      return setPeriod(ticks, clkSel, callback, params, duration);
+    }
+
+    // interval (in ns) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
+    bool setIntervalNs(const uint32_t& interval_ns, timer_callback callback, const unsigned long& duration = 0)
+    {
+      return setIntervalNs(interval_ns, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+    }
+
     // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     template<typename TArg>
     bool setInterval(const unsigned long& interval, void (*callback)(TArg), const TArg& params, const unsigned long& duration = 0)
     {
       static_assert(sizeof(TArg) <= sizeof(uint32_t), "setInterval() callback argument size must be <= 4 bytes");
-      return setFrequency((float) (1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
+      return setIntervalMs(interval, reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
     }
 
     // interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     bool setInterval(const unsigned long& interval, timer_callback callback, const unsigned long& duration = 0)
     {
-      return setFrequency((float) (1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
+      return setIntervalMs(interval, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0, duration);
     }
 
     template<typename TArg>
@@ -210,13 +579,13 @@ class TimerInterrupt
     bool attachInterruptInterval(const unsigned long& interval, void (*callback)(TArg), const TArg& params, const unsigned long& duration = 0)
     {
       static_assert(sizeof(TArg) <= sizeof(uint32_t), "attachInterruptInterval() callback argument size must be <= 4 bytes");
-      return setFrequency( (float) ( 1000.0f / interval), reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
+      return setIntervalMs(interval, reinterpret_cast<timer_callback_p>(callback), (uint32_t) params, duration);
     }
 
     // Interval (in ms) and duration (in milliseconds). Duration = 0 or not specified => run indefinitely
     bool attachInterruptInterval(const unsigned long& interval, timer_callback callback, const unsigned long& duration = 0)
     {
-      return setFrequency( (float) ( 1000.0f / interval), reinterpret_cast<timer_callback_p> (callback), /*NULL*/ 0, duration);
+      return setIntervalMs(interval, reinterpret_cast<timer_callback_p> (callback), /*NULL*/ 0, duration);
     }
 
     void detachInterrupt();
@@ -235,7 +604,7 @@ class TimerInterrupt
       reattachInterrupt(duration);
     }
 
-    // Just stop clock source, still keep the count
+    // Just stop clock source, still keep the count, the position within a long period and the remaining duration
     void pauseTimer();
 
     // Just reconnect clock source, continue from the current count
@@ -253,6 +622,140 @@ class TimerInterrupt
       reattachInterrupt(duration);
     }
 
+    // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc to force the TCB clock of this timer,
+    // TCB_CLKSEL_AUTO to let setFrequency() / setIntervalXX() select it. Applied by the next setFrequency() / setXX()
+    void setClockSource(const uint8_t& clkSel)
+    {
+      _autoClock = (clkSel == TCB_CLKSEL_AUTO);
+
+      if (!_autoClock)
+        _clkSel = clkSel;
+    }
+
+    // Max error (in ppm) accepted when selecting the TCB clock. The fewest interrupts per period within
+    // this error wins, the faster clock on a tie
+    void setMaxErrorPPM(const uint32_t& maxErrorPPM)
+    {
+      _maxErrorPPM = (maxErrorPPM > 0) ? maxErrorPPM : 1;
+    }
+
+    // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc
+    uint8_t getClockSource() __attribute__((always_inline))
+    {
+      return _clkSel;
+    }
+
+    // TCB clock (in Hz)
+    uint32_t getClockFrequency() __attribute__((always_inline))
+    {
+      return TimerInterrupt_clockOf(_clkSel);
+    }
+
+    // Actual frequency (in Hz) achieved with the selected clock and _CCMPValue
+    float getActualFrequency()
+    {
+      return (_CCMPValue == 0) ? 0 : ( (float) getClockFrequency() / _CCMPValue );
+    }
+
+    // Hardware 8-bit PWM on the WO pin of the TCB, without any interrupt. The period is (top + 1) ticks of the
+    // current TCB clock (see getClockSource()) and the output is high for the first duty ticks of each period :
+    // duty = 0 => always low, duty > top => always high. The WO pin must be set as OUTPUT, its alternate
+    // location being selected by PORTMUX.TCBROUTEA. Return false if top < 1
+    bool setPWM8(const uint8_t& top, const uint8_t& duty);
+
+    // PWM8 frequency (in Hz) and duty (0-255, as analogWrite()). Unless forced by setClockSource(), selects the
+    // fastest TCB clock reaching frequency, i.e. with the most duty steps. See TimerInterrupt_PWM8MinFrequency()
+    // and TimerInterrupt_PWM8MaxFrequency() for the range of each clock. Return false if out of range
+    bool setPWM8Frequency(const uint32_t& frequency, const uint8_t& duty);
+
+    // Change the PWM8 duty (0-255, as setPWM8Frequency()), without a glitch on the output.
+    // Return false if PWM8 isn't running on this timer
+    bool setPWM8Duty(const uint8_t& duty)
+    {
+      return setPWM8DutyTicks(TimerInterrupt_PWM8DutyTicks(duty, (uint16_t) _pwmTop + 1));
+    }
+
+    // Same with the duty in ticks, as setPWM8() : 0 => always low, > getPWM8Top() => always high
+    bool setPWM8DutyTicks(const uint8_t& duty);
+
+    // Stop PWM8 and set the TCB back to periodic interrupt mode, timer disabled
+    void stopPWM8();
+
+    uint8_t getPWM8Top() __attribute__((always_inline))
+    {
+      return _pwmTop;
+    }
+
+    // PWM8 high time, in ticks
+    uint8_t getPWM8DutyTicks() __attribute__((always_inline))
+    {
+      return _pwmDuty;
+    }
+
+    // Actual PWM8 frequency (in Hz), truncated
+    uint32_t getPWM8Frequency()
+    {
+      return getClockFrequency() / ( (uint16_t) _pwmTop + 1 );
+    }
+
+    // Hardware single-shot pulse / timeout of ticks (1-65535) ticks of the current TCB clock, started by each event
+    // on EVSYS channel (from a pin, another peripheral, or fireOneShot()). Events during the pulse are ignored.
+    // The WO pin, if set as OUTPUT, is high during the pulse. callback, if not NULL, is called at the end of the pulse
+    bool setOneShot(const uint16_t& ticks, const uint8_t& channel, timer_callback_p callback, const uint32_t& params);
+
+    bool setOneShot(const uint16_t& ticks, const uint8_t& channel, timer_callback callback = NULL)
+    {
+      return setOneShot(ticks, channel, reinterpret_cast<timer_callback_p>(callback), /*NULL*/ 0);
+    }
+
+    // pulse (in us). Selects the TCB clock as setIntervalUs(), unless forced by setClockSource().
+    // Return false if the pulse is longer than 65535 ticks of all allowed clocks
+    bool setOneShotUs(const uint32_t& pulse_us, const uint8_t& channel, timer_callback callback = NULL)
+    {
+      uint8_t clkSel;
+      uint32_t ticks = usToTicks(pulse_us, clkSel);
+
+      if ( (ticks == 0) || (ticks > MAX_COUNT_16BIT) )
+        return false;
+
+      _clkSel = clkSel;
+
+      return setOneShot(ticks, channel, callback);
+    }
+
+    // Software trigger of the one-shot, through the EVSYS channel given to setOneShot()
+    void fireOneShot() __attribute__((always_inline))
+    {
+      EVSYS.STROBE = (1 << _oneShotChannel);
+    }
+
+    // true while the one-shot pulse is running
+    bool isOneShotRunning() __attribute__((always_inline))
+    {
+      return (TimerTCB[_timer]->STATUS & TCB_RUN_bm);
+    }
+
+    // Stop the one-shot, disconnect it from its EVSYS channel and set the TCB back to periodic interrupt mode,
+    // timer disabled
+    void stopOneShot();
+
+    // Route the compare event of this timer, at the end of each period, to EVSYS channel. Users connected to
+    // the channel, e.g. by TimerInterrupt_setEventUser(EVSYS.USERADC0, channel), are then triggered by hardware
+    // without any ISR, and the callback of setTicks() / setIntervalXX() becomes optional (NULL). Without callback,
+    // the period may also be set first, then routed here.
+    // The period must be up to MAX_TICKS_PER_SEGMENT ticks, as the event comes at the end of each segment.
+    // Return false if channel is out of range or the current period is too long
+    bool setEventOutput(const uint8_t& channel);
+
+    // Disconnect the compare event from its EVSYS channel
+    void clearEventOutput();
+
+    // EVSYS channel driven by the compare event, or TIMER_NO_EVENT_CHANNEL
+    uint8_t getEventOutput() __attribute__((always_inline))
+    {
+      return _eventChannel;
+    }
+
     int8_t getTimer() __attribute__((always_inline))
     {
       return _timer;
@@ -277,56 +780,326 @@ class TimerInterrupt
       return _CCMPValue;
     };
 
-    uint32_t /*long*/ get_CCMPValueRemaining() __attribute__((always_inline))
+    // Ticks remaining in the current period, at the end of the current segment
+    uint32_t /*long*/ get_CCMPValueRemaining()
     {
-      return _CCMPValueRemaining;
+      uint16_t segmentsDone = _segments - _segmentsRemaining;
+      uint16_t longSegments = (_longSegments > segmentsDone) ? (_longSegments - segmentsDone) : 0;
+
+      return ( (uint32_t) (_segmentsRemaining - 1) * (_segmentCCMP + 1) ) + longSegments;
     };
 
-    void adjust_CCMPValue() //__attribute__((always_inline))
+    // Number of segments the period is split into
+    uint16_t getSegments() __attribute__((always_inline))
     {
-      noInterrupts();
-      
-      if (_CCMPValueRemaining < MAX_COUNT_16BIT)
-      {
-        set_CCMP();
-      }
-        
-      interrupts();  
+      return _segments;
+    };
 
-      _CCMPValueRemaining -= min(MAX_COUNT_16BIT, _CCMPValueRemaining);
+    // Segments of the current period ended and served by the ISR
+    uint16_t getSegmentsDone() __attribute__((always_inline))
+    {
+      return _segments - _segmentsRemaining;
+    };
+
+    // Ticks from the start of the current period to the end of its first segmentsDone segments
+    uint32_t getSegmentStartTicks(const uint16_t& segmentsDone)
+    {
+      uint16_t longSegments = (_longSegments < segmentsDone) ? _longSegments : segmentsDone;
+
+      return ( (uint32_t) segmentsDone * (_segmentCCMP + 1) ) + longSegments;
+    };
 
-      if (_CCMPValueRemaining <= 0)
+    // Ticks elapsed since the start of the current period, including a segment end not yet served by the ISR.
+    // Call with interrupts disabled
+    uint32_t getElapsedTicks()
+    {
+      TCB_t* tcb = TimerTCB[_timer];
+
+      uint16_t count        = tcb->CNT;
+      uint16_t segmentsDone = getSegmentsDone();
+
+      // Flag checked after CNT : if set, CNT may have wrapped after being read
+      if (tcb->INTFLAGS & TCB_CAPT_bm)
       {
-        // Reset value for next cycle
-        _CCMPValueRemaining = _CCMPValue;
-      
-        TISR_LOGDEBUG1(F("adjust_CCMPValue: reset _CCMPValueRemaining = "), _CCMPValue);
-        _timerDone = true;
+        count = tcb->CNT;
+        segmentsDone++;
       }
-      else
-        _timerDone = false;
+
+      return getSegmentStartTicks(segmentsDone) + count;
+    };
+
+#if TIMER_INTERRUPT_USE_STATS
+    // Copy of the statistics since resetStats(), in ticks of getClockFrequency(). Latency is read from CNT at
+    // ISR entry, which counts from the compare match. A callback running past the next compare match is counted
+    // as missed, but an ISR entered more than one period late can't be seen
+    void getStats(timer_stats_t& stats)
+    {
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      stats = _stats;
+
+      SREG = sreg;
     };
 
-    void reload_CCMPValue() //__attribute__((always_inline))
+    void resetStats()
     {
+      uint8_t sreg = SREG;
       noInterrupts();
 
-      // Reset value for next cycle, have to deduct the value already loaded to CCMP register 
-      _CCMPValueRemaining = _CCMPValue;
+      TimerInterrupt_resetStats(_stats);
+
+      SREG = sreg;
+    };
+#endif
+
+    // Change the period (in ticks of the current clock) of a running timer, keeping its callback and duration.
+    // The new period counts from the start of the current segment, so CNT must be below its first segment.
+    // Call with interrupts disabled, e.g. from the callback
+    void reloadTicks(const uint32_t& ticks)
+    {
+      _CCMPValue = ticks;
+
       set_CCMP();
-      
-      _timerDone = false;
 
-      interrupts();
+      // From ISR : traced, where setPeriod() prints
+      TISR_TRACEDEBUG(TISR_TRACE_CCMP_RELOAD, _timer, ticks, _segments);
+    };
+
+    // Called from ISR at the end of each segment. Return true at the end of the period.
+    // CCMP is rewritten only when the length of the next segment differs
+    bool nextSegment(TCB_t& tcb) __attribute__((always_inline))
+    {
+      uint16_t segmentsRemaining = _segmentsRemaining - 1;
+
+      if (segmentsRemaining == 0)
+      {
+        _segmentsRemaining = _segments;
+
+        // Next period starts with the long segments
+        if (_longSegments != 0)
+          tcb.CCMP = _segmentCCMP + 1;
+
+        return true;
+      }
+
+      _segmentsRemaining = segmentsRemaining;
+
+      // Long segments done. Never true if _longSegments == 0
+      if (segmentsRemaining == _segments - _longSegments)
+        tcb.CCMP = _segmentCCMP;
+
+      return false;
     };
 
-    bool checkTimerDone() //__attribute__((always_inline))
+    // Body of ISR(TCBn_INT_vect), for this timer and its tcb. POLICY flags remove at compile time the code for
+    // duration counting, long period segments and callback parameter. With TIMER_ISR_POLICY_MINIMAL,
+    // what's left is the NULL test and indirect call of the callback, and clearing the interrupt flag
+    template<uint8_t POLICY>
+    __attribute__((always_inline)) void handleInterrupt(TCB_t& tcb)
     {
-      return _timerDone;
+#if TIMER_INTERRUPT_USE_STATS
+      // Ticks since the compare match
+      uint16_t entryCount = tcb.CNT;
+#endif
+
+      TISR_TRACEDEBUG(TISR_TRACE_ISR_ENTER, _timer, tcb.CNT, _segmentsRemaining);
+
+      long countLocal = 0;
+
+      if ( !(POLICY & TIMER_ISR_NO_DURATION) )
+      {
+        countLocal = _toggle_count;
+
+        if (countLocal == 0)
+        {
+          TISR_TRACEWARN(TISR_TRACE_TIMER_DONE, _timer, 0, 0);
+
+          detachInterrupt();
+
+          TISR_TRACEDEBUG(TISR_TRACE_ISR_EXIT, _timer, 0, 0);
+
+          return;
+        }
+      }
+
+      // CCMP is rewritten only if the next segment length differs. True at the end of the period
+      if ( (POLICY & TIMER_ISR_NO_LONG_PERIOD) || nextSegment(tcb) )
+      {
+#if TIMER_INTERRUPT_USE_STATS
+        uint16_t startCount = tcb.CNT;
+#endif
+
+        TISR_TRACEDEBUG(TISR_TRACE_CALLBACK_START, _timer, 0, 0);
+
+        if ( !(POLICY & TIMER_ISR_NO_DEFER) && (_eventQueue != NULL) )
+          postCallback();
+        else if (POLICY & TIMER_ISR_NO_PARAMS)
+        {
+          // As callback(), as the interrupt may be enabled with no callback
+          if (_callback != NULL)
+            (*(timer_callback) _callback)();
+        }
+        else
+          callback();
+
+        TISR_TRACEDEBUG(TISR_TRACE_CALLBACK_END, _timer, 0, 0);
+
+#if TIMER_INTERRUPT_USE_STATS
+        uint16_t endCount = tcb.CNT;
+        uint32_t duration = endCount - startCount;
+
+        // CNT wrapped : the next compare match came during the callback. CCMP may already be the next segment's,
+        // off by one tick
+        if (endCount < startCount)
+        {
+          duration = ( (uint32_t) tcb.CCMP + 1 - startCount ) + endCount;
+          TimerInterrupt_addMissed(_stats, 1);
+        }
+
+        TimerInterrupt_addStats(_stats, entryCount, duration);
+#endif
+
+        if ( !(POLICY & TIMER_ISR_NO_DURATION) && (countLocal > 0) )
+          _toggle_count = countLocal - 1;
+      }
+
+      // Clear interrupt flag
+      tcb.INTFLAGS = TCB_CAPT_bm;
+
+      TISR_TRACEDEBUG(TISR_TRACE_ISR_EXIT, _timer, 0, 0);
     };
 
 }; // class TimerInterrupt
 
 //////////////////////////////////////////////
 
+// Compile-time counterpart of TimerInterrupt::setFrequency() for rates known at build time.
+// CCMP, the number of 65535-tick chunks and the TCB clock are computed by the compiler,
+// attachInterrupt() is then just the register writes.
+
+#ifndef TIMER_INTERRUPT_FIXED_TOLERANCE_PPM
+  // Max error (in ppm) between requested and achieved frequency, if not specified as template argument
+  #define TIMER_INTERRUPT_FIXED_TOLERANCE_PPM       1000UL
+#endif
+
+constexpr bool TimerInterrupt_usable(const uint8_t clkSel, const uint32_t hz, const uint32_t div, const uint32_t ppm)
+{
+  return ( TimerInterrupt_ticksOf(TimerInterrupt_clockOf(clkSel), hz, div) >= 1 ) &&
+         ( TimerInterrupt_ticksOf(TimerInterrupt_clockOf(clkSel), hz, div) <= MAX_TICKS_PER_PERIOD ) &&
+         ( TimerInterrupt_errorPPMOf(TimerInterrupt_ticksOf(TimerInterrupt_clockOf(clkSel), hz, div),
+                                     TimerInterrupt_clockOf(clkSel), hz, div) <= ppm );
+}
+
+// Of clkSel a and b (a being the faster clock), select the usable one giving the fewest chunks
+constexpr uint8_t TimerInterrupt_betterClock(const uint8_t a, const uint8_t b, const uint32_t hz, const uint32_t div,
+                                             const uint32_t ppm)
+{
+  return !TimerInterrupt_usable(b, hz, div, ppm) ? a : ( !TimerInterrupt_usable(a, hz, div, ppm) ? b :
+         ( ( TimerInterrupt_chunksOf(TimerInterrupt_ticksOf(TimerInterrupt_clockOf(b), hz, div)) <
+             TimerInterrupt_chunksOf(TimerInterrupt_ticksOf(TimerInterrupt_clockOf(a), hz, div)) ) ? b : a ) );
+}
+
+// Frequency is FREQUENCY_HZ / FREQUENCY_DIV Hz, e.g. TimerInterruptFixed<HW_TIMER_1, 1, 10> for 0.1Hz.
+// timer must be the TimerInterrupt of the same TCB, e.g. ITimer1 for HW_TIMER_1
+template<uint8_t TIMER_NO, uint32_t FREQUENCY_HZ, uint32_t FREQUENCY_DIV = 1,
+         uint32_t TOLERANCE_PPM = TIMER_INTERRUPT_FIXED_TOLERANCE_PPM>
+class TimerInterruptFixed
+{
+    static_assert(TIMER_NO < NUM_HW_TIMERS, "TimerInterruptFixed: TIMER_NO must be HW_TIMER_0 to HW_TIMER_3");
+    static_assert((FREQUENCY_HZ > 0) && (FREQUENCY_DIV > 0), "TimerInterruptFixed: frequency must be > 0");
+
+  public:
+
+    // TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc or TCB_CLKSEL_CLKTCA_gc
+    static constexpr uint8_t  CLKSEL  = TimerInterrupt_betterClock(TimerInterrupt_betterClock(TCB_CLKSEL_CLKDIV1_gc,
+                                                                   TCB_CLKSEL_CLKDIV2_gc, FREQUENCY_HZ, FREQUENCY_DIV, TOLERANCE_PPM),
+                                                                   TCB_CLKSEL_CLKTCA_gc, FREQUENCY_HZ, FREQUENCY_DIV, TOLERANCE_PPM);
+
+    static_assert(TimerInterrupt_usable(CLKSEL, FREQUENCY_HZ, FREQUENCY_DIV, TOLERANCE_PPM),
+                  "TimerInterruptFixed: frequency can't be reached within TOLERANCE_PPM with any TCB clock");
+
+    static constexpr uint32_t CLOCK     = TimerInterrupt_clockOf(CLKSEL);
+    static constexpr uint32_t TICKS     = (uint32_t) TimerInterrupt_ticksOf(CLOCK, FREQUENCY_HZ, FREQUENCY_DIV);
+    static constexpr uint32_t CHUNKS    = (uint32_t) TimerInterrupt_chunksOf(TICKS);
+    static constexpr uint32_t ERROR_PPM = (uint32_t) TimerInterrupt_errorPPMOf(TICKS, CLOCK, FREQUENCY_HZ, FREQUENCY_DIV);
+
+    // Segments as computed by set_CCMP()
+    static constexpr uint16_t SEGMENT_CCMP  = (uint16_t) ( (TICKS / CHUNKS) - 1 );
+    static constexpr uint16_t LONG_SEGMENTS = (uint16_t) (TICKS % CHUNKS);
+    static constexpr uint16_t CCMP          = (LONG_SEGMENTS != 0) ? SEGMENT_CCMP + 1 : SEGMENT_CCMP;
+
+    static_assert( (CHUNKS == 1) || !(TimerInterrupt_policyOf(TIMER_NO) & TIMER_ISR_NO_LONG_PERIOD),
+                   "TimerInterruptFixed: period too long for TIMER_ISR_NO_LONG_PERIOD policy of this timer");
+
+    // Run indefinitely, from the timer compare mode, i.e. leaving any PWM8, one-shot or EVSYS output mode, and
+    // without event queue (call setEventQueue() afterwards to defer the callback). No interrupt if callback is NULL.
+    // Return false if timer is not ITimerN of TIMER_NO, as ISR(TCBn_INT_vect) serves only that one, or if params
+    // is not NULL under the TIMER_ISR_NO_PARAMS policy of this timer, its ISR calling the callback without parameter
+    static bool attachInterrupt(TimerInterrupt& timer, timer_callback_p callback, void* params)
+    {
+      if (timer.getTimer() != TIMER_NO)
+      {
+        TISR_LOGDEBUG1(F("TimerInterruptFixed: wrong TimerInterrupt for TCB"), TIMER_NO);
+
+        return false;
+      }
+
+      if ( (TimerInterrupt_policyOf(TIMER_NO) & TIMER_ISR_NO_PARAMS) && (params != NULL) )
+      {
+        TISR_LOGDEBUG1(F("TimerInterruptFixed: params not allowed by ISR policy "), TimerInterrupt_policyOf(TIMER_NO));
+
+        return false;
+      }
+
+      // TCB0-TCB3 are contiguous TCB_t register blocks
+      TCB_t& tcb = (&TCB0)[TIMER_NO];
+
+      uint8_t sreg = SREG;
+      noInterrupts();
+
+      tcb.CTRLA     = 0;                              // Disable timer while reconfiguring
+      tcb.INTCTRL   = 0;
+
+      // As stopOneShot() : TCB no longer started by its EVSYS channel
+      if ( (tcb.CTRLB & TCB_CNTMODE_gm) == TCB_CNTMODE_SINGLE_gc )
+        TimerInterrupt_clearTimerEventUser(TIMER_NO);
+
+      timer.clearEventOutput();
+
+      timer._clkSel             = CLKSEL;
+      timer._callback           = (void*) callback;
+      timer._params             = params;
+      timer._eventQueue         = NULL;
+      timer._toggle_count       = -1;
+      timer._CCMPValue          = TICKS;
+      timer._segments           = CHUNKS;
+      timer._segmentsRemaining  = CHUNKS;
+      timer._segmentCCMP        = SEGMENT_CCMP;
+      timer._longSegments       = LONG_SEGMENTS;
+      timer._pwmTop             = 0;
+      timer._pwmDuty            = 0;
+
+      tcb.CTRLB     = TCB_CNTMODE_INT_gc;             // Use timer compare mode
+      tcb.EVCTRL    = 0;
+      tcb.CNT       = 0;
+      tcb.CCMP      = CCMP;                           // Value to compare with.
+      tcb.INTFLAGS  = TCB_CAPT_bm;                    // Clear interrupt flag
+      tcb.INTCTRL   = (callback != NULL) ? TCB_CAPT_bm : 0;   // Enable the interrupt, unless no callback
+      tcb.CTRLA     = CLKSEL | TCB_ENABLE_bm;         // Select clock, enable timer
+
+      SREG = sreg;
+
+      return true;
+    }
+
+    // Run indefinitely
+    static bool attachInterrupt(TimerInterrupt& timer, timer_callback callback)
+    {
+      return attachInterrupt(timer, reinterpret_cast<timer_callback_p>(callback), NULL);
+    }
+};
+
+//////////////////////////////////////////////
+
 #endif      //#ifndef MEGA_AVR_TIMERINTERRUPT_HPP
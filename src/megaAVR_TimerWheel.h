@@ -0,0 +1,37 @@
+/****************************************************************************************************************************
+  megaAVR_TimerWheel.h
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerWheel is an alternative to ISR_Timer for hundreds of mostly short-lived software timers, e.g. one timeout
+  per connection or message. Timers are kept in a hierarchical timing wheel, with nodes from a fixed pool, so that
+  setting, deleting and the per-tick run() are O(1), whatever the number of timers. Core-agnostic : no register
+  access, so it also builds on the host, see extras/TimerWheel_Benchmark.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMERWHEEL_H
+#define MEGA_AVR_TIMERWHEEL_H
+
+// TimerWheelT is a template, all in the .hpp, which can be included in any number of files
+#include "megaAVR_TimerWheel.hpp"
+
+#endif      //#ifndef MEGA_AVR_TIMERWHEEL_H
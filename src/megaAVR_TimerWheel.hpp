@@ -0,0 +1,450 @@
+/****************************************************************************************************************************
+  megaAVR_TimerWheel.hpp
+  For Arduino megaAVR ATMEGA4809-based boards (UNO WiFi Rev2, NANO_EVERY, etc. )
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/megaAVR_TimerInterrupt
+  Licensed under MIT license
+
+  TimerWheel is an alternative to ISR_Timer for hundreds of mostly short-lived software timers, e.g. one timeout
+  per connection or message. Timers are kept in a hierarchical timing wheel, with nodes from a fixed pool, so that
+  setting, deleting and the per-tick run() are O(1), whatever the number of timers. Core-agnostic : no register
+  access, so it also builds on the host, see extras/TimerWheel_Benchmark.
+
+  Version: 1.7.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      01/04/2021 Initial coding to support Arduino megaAVR ATmega4809-based boards (UNO WiFi Rev2, etc.)
+  1.1.0   K.Hoang      14/04/2021 Fix bug. Don't use v1.0.0
+  1.2.0   K.Hoang      17/04/2021 Selectable TCB Clock 16MHz, 8MHz or 250KHz depending on necessary accuracy
+  1.3.0   K.Hoang      17/04/2021 Fix TCB Clock bug. Don't use v1.2.0
+  1.4.0   K.Hoang      19/11/2021 Fix TCB Clock bug in high frequencies
+  1.5.0   K.Hoang      22/01/2022 Fix `multiple-definitions` linker error
+  1.6.0   K.Hoang      05/02/2022 Add support to MegaCoreX core
+  1.6.1   K.Hoang      25/04/2022 Suppress warnings when _TIMERINTERRUPT_LOGLEVEL_ < 2
+  1.7.0   K.Hoang      11/11/2022 Fix bug disabling TCB0
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MEGA_AVR_TIMERWHEEL_HPP
+#define MEGA_AVR_TIMERWHEEL_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+#endif
+
+#ifndef TIMER_WHEEL_LEVEL_BITS
+  // Each level of the wheel has 2^TIMER_WHEEL_LEVEL_BITS slots
+  #define TIMER_WHEEL_LEVEL_BITS      5
+#endif
+
+#ifndef TIMER_WHEEL_LEVELS
+  // Delays up to 2^(TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS) ticks are placed directly, longer ones are placed
+  // at the last slot of the top level then again. 2^20 ticks is about 17 minutes with 1ms ticks
+  #define TIMER_WHEEL_LEVELS          4
+#endif
+
+#if ( (TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS > 31) || ( (1 << TIMER_WHEEL_LEVEL_BITS) * TIMER_WHEEL_LEVELS > 255 ) )
+  #error TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS must be up to 31, with up to 255 slots in all
+#endif
+
+// The wheel is changed from loop() and from run() in ISR. Lists can't be updated atomically, so changes are done
+// with interrupts disabled, restoring SREG afterwards as timers are also set and deleted from callbacks.
+// Empty on the host
+#ifndef TIMER_WHEEL_LOCK
+  #if defined(__AVR__)
+    #define TIMER_WHEEL_LOCK()        uint8_t timerWheelSREG = SREG; cli()
+    #define TIMER_WHEEL_UNLOCK()      SREG = timerWheelSREG
+  #else
+    #define TIMER_WHEEL_LOCK()
+    #define TIMER_WHEEL_UNLOCK()
+  #endif
+#endif
+
+typedef void (*timer_callback)();
+typedef void (*timer_callback_p)(void *);
+
+// POOL_SIZE : max number of timers, up to 1024. Each takes 20 bytes of SRAM on AVR, plus 2 bytes per wheel slot
+// (256 bytes with the default 4 levels of 32 slots).
+// Time is in ticks, i.e. calls to run(). With run() called every ms by a TimerInterrupt, as ISR_Timer, delays are
+// in ms. Timer ids are generation-tagged, so that deleting a timer which already expired, its slot being reused,
+// is a no-op instead of deleting another timer.
+template<uint16_t POOL_SIZE>
+class TimerWheelT
+{
+    static_assert( (POOL_SIZE >= 1) && (POOL_SIZE <= 1024), "TimerWheelT: pool size must be 1 to 1024");
+
+  public:
+
+    // setTimer() constants
+    const static int RUN_FOREVER = 0;
+    const static int RUN_ONCE = 1;
+
+    TimerWheelT()
+    {
+      init();
+    }
+
+    // Delete all timers, and restart time from 0
+    void init()
+    {
+      TIMER_WHEEL_LOCK();
+
+      _now        = 0;
+      _numTimers  = 0;
+      _running    = NIL;
+
+      for (uint8_t i = 0; i < NUM_SLOTS; i++)
+        _slots[i] = NIL;
+
+      // Free list through next
+      for (uint16_t i = 0; i < POOL_SIZE; i++)
+      {
+        _nodes[i].next  = i + 1;
+        _nodes[i].flags = 0;
+      }
+
+      _nodes[POOL_SIZE - 1].next = NIL;
+      _free = 0;
+
+      TIMER_WHEEL_UNLOCK();
+    }
+
+    // To be called every tick, from the ISR of a TimerInterrupt. Runs the callbacks of the timers due at this tick
+    void run()
+    {
+      uint8_t index = _now & SLOT_MASK;
+
+      // Level 0 wrapped : move the timers of the next slot of level 1 down, and so on up the levels
+      if (index == 0)
+      {
+        for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+        {
+          uint8_t levelIndex = (_now >> (level * TIMER_WHEEL_LEVEL_BITS)) & SLOT_MASK;
+
+          cascade(level * SLOTS_PER_LEVEL + levelIndex);
+
+          if (levelIndex != 0)
+            break;
+        }
+      }
+
+      // One node at a time, as callbacks may delete others of the slot. Timers they set are due at least one
+      // tick later, so never in this slot
+      uint16_t node;
+
+      while ( (node = _slots[index]) != NIL )
+      {
+        node_t& t = _nodes[node];
+
+        unlink(node);
+
+        // Deleted or changed by its callback, if _running is reset
+        _running = node;
+
+        if (t.flags & FLAG_PARAM)
+          (*(timer_callback_p) t.callback)(t.param);
+        else
+          (*(timer_callback) t.callback)();
+
+        if (_running == node)
+        {
+          if ( (t.runsLeft != RUN_FOREVER) && (--t.runsLeft == 0) )
+          {
+            release(node);
+          }
+          else
+          {
+            t.expires += t.period;
+            place(node);
+          }
+        }
+
+        _running = NIL;
+      }
+
+      _now++;
+    }
+
+    // Timer will call function 'f' every 'd' ticks forever
+    // returns the timer id on success or -1 on failure (f == NULL) or no free timers
+    int setInterval(const uint32_t& d, timer_callback f)
+    {
+      return setupTimer(d, (void *) f, NULL, false, RUN_FOREVER);
+    }
+
+    int setInterval(const uint32_t& d, timer_callback_p f, void* p)
+    {
+      return setupTimer(d, (void *) f, p, true, RUN_FOREVER);
+    }
+
+    // Timer will call function 'f' after 'd' ticks one time
+    int setTimeout(const uint32_t& d, timer_callback f)
+    {
+      return setupTimer(d, (void *) f, NULL, false, RUN_ONCE);
+    }
+
+    int setTimeout(const uint32_t& d, timer_callback_p f, void* p)
+    {
+      return setupTimer(d, (void *) f, p, true, RUN_ONCE);
+    }
+
+    // Timer will call function 'f' every 'd' ticks 'n' times
+    int setTimer(const uint32_t& d, timer_callback f, const uint16_t& n)
+    {
+      return setupTimer(d, (void *) f, NULL, false, n);
+    }
+
+    int setTimer(const uint32_t& d, timer_callback_p f, void* p, const uint16_t& n)
+    {
+      return setupTimer(d, (void *) f, p, true, n);
+    }
+
+    // destroy the specified timer. No-op if it already expired
+    void deleteTimer(const int& id)
+    {
+      TIMER_WHEEL_LOCK();
+
+      uint16_t node = nodeOf(id);
+
+      if (node != NIL)
+      {
+        // The running timer isn't in a slot list
+        if (node == _running)
+          _running = NIL;
+        else
+          unlink(node);
+
+        release(node);
+      }
+
+      TIMER_WHEEL_UNLOCK();
+    }
+
+    // updates interval of the specified timer, then due 'd' ticks from now
+    bool changeInterval(const int& id, const uint32_t& d)
+    {
+      TIMER_WHEEL_LOCK();
+
+      uint16_t node = nodeOf(id);
+
+      if (node != NIL)
+      {
+        node_t& t = _nodes[node];
+
+        t.period = (d > 0) ? d : 1;
+
+        // From its own callback : placed by run(), period added
+        if (node == _running)
+        {
+          t.expires = _now;
+        }
+        else
+        {
+          unlink(node);
+
+          t.expires = _now + t.period;
+
+          place(node);
+        }
+      }
+
+      TIMER_WHEEL_UNLOCK();
+
+      return (node != NIL);
+    }
+
+    // true if the timer id is set, i.e. not deleted or expired
+    bool isActive(const int& id)
+    {
+      return (nodeOf(id) != NIL);
+    }
+
+    // Ticks since init()
+    uint32_t now()
+    {
+      return _now;
+    }
+
+    // returns the number of used timers
+    uint16_t getNumTimers()
+    {
+      return _numTimers;
+    }
+
+    // returns the number of available timers
+    uint16_t getNumAvailableTimers()
+    {
+      return POOL_SIZE - _numTimers;
+    }
+
+  private:
+
+    const static uint8_t  SLOTS_PER_LEVEL = 1 << TIMER_WHEEL_LEVEL_BITS;
+    const static uint8_t  SLOT_MASK       = SLOTS_PER_LEVEL - 1;
+    const static uint8_t  NUM_SLOTS       = SLOTS_PER_LEVEL * TIMER_WHEEL_LEVELS;
+    const static uint32_t RANGE           = 1UL << (TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS);
+
+    const static uint16_t NIL             = 0xFFFF;
+
+    // Ids are node index in the low 10 bits, generation in the next 5, so always positive as int
+    const static uint8_t  INDEX_BITS      = 10;
+    const static uint16_t INDEX_MASK      = (1 << INDEX_BITS) - 1;
+    const static uint8_t  GENERATION_MASK = 0x1F;
+
+    // flags : generation in bits 0-4
+    const static uint8_t  FLAG_USED       = 0x80;
+    const static uint8_t  FLAG_PARAM      = 0x40;
+
+    // 20 bytes on AVR
+    typedef struct
+    {
+      uint32_t expires;                 // tick when due
+      uint32_t period;                  // delay value
+      void*    callback;                // pointer to the callback function
+      void*    param;                   // function parameter
+      uint16_t next;                    // in the slot list, or the free list
+      uint16_t prev;                    // in the slot list, NIL for the first node
+      uint16_t runsLeft;                // number of runs left, 0 for RUN_FOREVER
+      uint8_t  slot;                    // slot of the list
+      uint8_t  flags;
+    } node_t;
+
+    node_t    _nodes[POOL_SIZE];
+    uint16_t  _slots[NUM_SLOTS];
+
+    uint16_t  _free;
+    uint16_t  _numTimers;
+
+    // Current tick, i.e. the next one for run()
+    uint32_t  _now;
+
+    // Node whose callback is being called by run(), out of any slot list. NIL if deleted meanwhile
+    uint16_t  _running;
+
+    int setupTimer(const uint32_t& d, void* f, void* p, bool h, const uint16_t& n)
+    {
+      if (f == NULL)
+        return -1;
+
+      int id = -1;
+
+      TIMER_WHEEL_LOCK();
+
+      if (_free != NIL)
+      {
+        uint16_t node = _free;
+        node_t&  t    = _nodes[node];
+
+        _free = t.next;
+
+        t.callback  = f;
+        t.param     = p;
+        t.runsLeft  = n;
+        t.period    = (d > 0) ? d : 1;
+        t.expires   = _now + t.period;
+
+        // New generation
+        t.flags     = FLAG_USED | (h ? FLAG_PARAM : 0) | ( (t.flags + 1) & GENERATION_MASK );
+
+        place(node);
+
+        _numTimers++;
+
+        id = ( (int) (t.flags & GENERATION_MASK) << INDEX_BITS ) | node;
+      }
+
+      TIMER_WHEEL_UNLOCK();
+
+      return id;
+    }
+
+    // Node of a valid id, or NIL
+    uint16_t nodeOf(const int& id)
+    {
+      if (id < 0)
+        return NIL;
+
+      uint16_t node = id & INDEX_MASK;
+
+      if ( (node >= POOL_SIZE) || !(_nodes[node].flags & FLAG_USED) ||
+           ( (_nodes[node].flags & GENERATION_MASK) != ((id >> INDEX_BITS) & GENERATION_MASK) ) )
+        return NIL;
+
+      return node;
+    }
+
+    // Slot list of node, from its expiry : the lowest level whose slots still span the delay
+    void place(const uint16_t& node)
+    {
+      node_t& t = _nodes[node];
+
+      uint32_t delta    = t.expires - _now;
+      uint32_t expires  = t.expires;
+      uint8_t  level    = 0;
+
+      // Beyond the wheel : at the slot reached last, then placed again from there
+      if (delta >= RANGE)
+        expires = _now + RANGE - 1;
+
+      while ( (level < TIMER_WHEEL_LEVELS - 1) &&
+              ( (expires - _now) >= (1UL << ((level + 1) * TIMER_WHEEL_LEVEL_BITS)) ) )
+        level++;
+
+      uint8_t slot = level * SLOTS_PER_LEVEL + ( (expires >> (level * TIMER_WHEEL_LEVEL_BITS)) & SLOT_MASK );
+
+      t.slot  = slot;
+      t.prev  = NIL;
+      t.next  = _slots[slot];
+
+      if (t.next != NIL)
+        _nodes[t.next].prev = node;
+
+      _slots[slot] = node;
+    }
+
+    void unlink(const uint16_t& node)
+    {
+      node_t& t = _nodes[node];
+
+      if (t.prev != NIL)
+        _nodes[t.prev].next = t.next;
+      else
+        _slots[t.slot] = t.next;
+
+      if (t.next != NIL)
+        _nodes[t.next].prev = t.prev;
+    }
+
+    void release(const uint16_t& node)
+    {
+      _nodes[node].flags &= ~(FLAG_USED | FLAG_PARAM);
+      _nodes[node].next   = _free;
+
+      _free = node;
+      _numTimers--;
+    }
+
+    // Move the timers of a slot of an upper level down to the levels below
+    void cascade(const uint8_t& slot)
+    {
+      uint16_t node = _slots[slot];
+      _slots[slot]  = NIL;
+
+      while (node != NIL)
+      {
+        uint16_t next = _nodes[node].next;
+
+        place(node);
+
+        node = next;
+      }
+    }
+};
+
+#endif    // MEGA_AVR_TIMERWHEEL_HPP